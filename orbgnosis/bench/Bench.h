@@ -0,0 +1,84 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Odds and ends shared by the benchmarks: a fixed seed random number
+ * generator (so the cases don't depend on the C library), quantiles, and
+ * how long to time each measurement.
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+#define MIN_TIME 0.5    //!< seconds; time each measurement at least this long.
+
+static uint64_t rng_state;  //!< xorshift64* state, never zero.
+
+/**
+ * Start a new random number stream.  Stream s of a given seed is always
+ * the same, whatever other streams are used.
+ */
+static inline void
+bench_seed ( unsigned long seed, int s )
+{
+    rng_state = 0x9e3779b97f4a7c15ULL ^ ( seed * 2654435761UL + s );
+}
+
+/**
+ * A uniform random number in [lo, hi).  This is xorshift64*.
+ */
+static inline double
+uniform ( double lo, double hi )
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    uint64_t x = rng_state * 2685821657736338717ULL;
+    return lo + ( hi - lo ) * ( ( x >> 11 ) * ( 1.0 / 9007199254740992.0 ) );
+}
+
+/**
+ * Quantile q of a sorted vector, or -1 if it's empty.
+ */
+template <class T> static inline double
+quantile ( const vector<T>& x, double q )
+{
+    if ( x.empty() )
+        return -1.0;
+
+    return (double)x[ (size_t)( q * ( x.size() - 1 ) + 0.5 ) ];
+}
+
+#endif /* _BENCH_H_ */
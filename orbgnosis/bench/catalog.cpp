@@ -0,0 +1,401 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Catalog propagation benchmark.
+ *
+ * Builds a synthetic catalog (LEO shells, a few eccentric and a few open
+ * orbits) and propagates it to a series of epochs two ways: one Traj at
+ * a time through propagate(), as a Constellation would, and all at once
+ * through Catalog::propagate_to().  Reports objects per second for both,
+ * and the largest position difference between them, for the two-body
+ * and the secular J2 propagators.
+ *
+ * Then indexes the catalog with OrbitIndex, advances it a day, and asks
+ * for the neighbors of every tenth object, within 2 degrees of plane and
+ * 30 degrees of phase, checking each answer against a scan of the whole
+ * catalog.  Reports advance() and query times and how much of the catalog
+ * a query looks at.
+ *
+ *   catalog [seed [objects [results_file]]]
+ *
+ * The results file is CSV, one "suite,propagator,metric,value" record
+ * per line, so two runs can be compared with diff or a spreadsheet.
+ */
+
+#include "Vec3.h"
+#include "Bench.h"
+#include "Catalog.h"
+#include "Kepler.h"
+#include "OrbitIndex.h"
+#include "Orbgnosis.h"
+#include "Timer.h"
+#include "Traj.h"
+#include "TrajState.h"
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+#define EPOCHS 8    //!< epochs per timed pass, spread over a day.
+
+/**
+ * What one propagator did.
+ */
+struct CatalogResult
+{
+    double traj_per_s;      //!< objects per second, one Traj at a time.
+    double catalog_per_s;   //!< objects per second, Catalog::propagate_to().
+    double err_max;         //!< largest position difference (km).
+    int failures;           //!< objects either way couldn't propagate.
+};
+
+/**
+ * Generate the catalog.  Mostly near-circular LEO, one object in fifty
+ * eccentric, one in a thousand hyperbolic.
+ */
+static vector<Traj>
+make_catalog ( int objects )
+{
+    vector<Traj> t;
+
+    for ( int k = 0; k < objects; k++ )
+    {
+        double a, e;
+
+        if ( 0 == k % 1000 )
+        {
+            e = uniform( 1.1, 3.0 );
+            a = uniform( 1.1, 2.0 ) / ( 1.0 - e );
+        }
+        else if ( 0 == k % 50 )
+        {
+            a = uniform( 2.0, 7.0 );
+            e = uniform( 0.1, 1.0 - 1.05 / a );
+        }
+        else
+        {
+            a = uniform( 1.05, 1.3 );
+            e = uniform( 0.0, 0.01 );
+        }
+
+        double f_max = ( e < 1.0 ) ? M_PI : 0.8 * acos( -1.0 / e );
+        t.push_back( Traj( a, e, uniform( 0.0, M_PI ), uniform( 0.0, 2.0 * M_PI ),
+                           uniform( 0.0, 2.0 * M_PI ), uniform( -f_max, f_max ) ) );
+    }
+
+    return t;
+}
+
+/**
+ * The epoch of pass p, step s.
+ */
+static double
+epoch ( int p, int s )
+{
+    return ( 1.0 + s + 0.01 * p ) * 86400.0 / TU_SEC / EPOCHS;
+}
+
+/**
+ * Propagate the catalog both ways with the run's propagator.
+ */
+static CatalogResult
+run ( vector<Traj>& t, Catalog& cat )
+{
+    CatalogResult res;
+    vector<TrajState> s( t.size() );
+    long total = 0;
+    double start, elapsed;
+
+    res.err_max = 0.0;
+    res.failures = 0;
+
+    // One Traj at a time, and check against the catalog at the last epoch.
+    start = wall_time();
+
+    for ( int p = 0; ( 0 == p ) || ( wall_time() - start < MIN_TIME ); p++ )
+    {
+        for ( int e = 0; e < EPOCHS; e++ )
+            for ( size_t k = 0; k < t.size(); k++ )
+            {
+                try
+                {
+                    s[ k ] = propagate( t[ k ], epoch( 0, e ) );
+                }
+                catch ( int ex )
+                {
+                    s[ k ].r = Vec3( NAN, NAN, NAN );
+                }
+            }
+
+        total += (long)( t.size() * EPOCHS );
+    }
+
+    elapsed = wall_time() - start;
+    res.traj_per_s = total / elapsed;
+
+    res.failures = cat.propagate_to( epoch( 0, EPOCHS - 1 ) );
+
+    for ( size_t k = 0; k < t.size(); k++ )
+    {
+        double err = ER * norm( cat.get_state( (int)k ).r - s[ k ].r );
+
+        if ( isnan( err ) )
+            res.failures++;
+        else if ( err > res.err_max )
+            res.err_max = err;
+    }
+
+    // The whole catalog at once.
+    total = 0;
+    start = wall_time();
+
+    for ( int p = 0; ( 0 == p ) || ( wall_time() - start < MIN_TIME ); p++ )
+    {
+        for ( int e = 0; e < EPOCHS; e++ )
+            cat.propagate_to( epoch( p, e ) );
+
+        total += (long)( t.size() * EPOCHS );
+    }
+
+    elapsed = wall_time() - start;
+    res.catalog_per_s = total / elapsed;
+    return res;
+}
+
+/**
+ * What OrbitIndex did.
+ */
+struct IndexResult
+{
+    double advance_s;       //!< seconds per advance() of a day.
+    int moved;              //!< objects which changed cells in that day.
+    double index_per_s;     //!< queries per second through the index.
+    double scan_per_s;      //!< queries per second scanning the catalog.
+    double looked;          //!< mean fraction of the catalog looked at.
+    double found;           //!< mean neighbors per query.
+    int wrong;              //!< queries whose answer differs from the scan.
+};
+
+/**
+ * Neighbors of object k by scanning the whole catalog.
+ */
+static void
+scan ( const OrbitIndex& idx, int n, int k, double max_angle, double max_phase,
+       const Catalog& cat, vector<int>& out )
+{
+    out.clear();
+
+    for ( int j = 0; j < n; j++ )
+    {
+        if ( ( j == k ) || ( idx.plane_angle( j, k ) > max_angle ) )
+            continue;
+
+        double du = fmod( idx.get_argLat( j ) - idx.get_argLat( k ) + 3.0 * M_PI,
+                          2.0 * M_PI ) - M_PI;
+
+        if ( ( cat.e[ j ] < 1.0 ) && ( cat.e[ k ] < 1.0 ) && ( fabs( du ) > max_phase ) )
+            continue;
+
+        out.push_back( j );
+    }
+}
+
+/**
+ * Index the catalog, a day on, with J2, and compare queries with scans.
+ */
+static IndexResult
+run_index ( Catalog& cat )
+{
+    const double max_angle = 2.0 * M_PI / 180.0;
+    const double max_phase = 30.0 * M_PI / 180.0;
+    int n = cat.size();
+    IndexResult res;
+    vector<int> a, b;
+    long total;
+    double start, looked = 0.0, found = 0.0;
+
+    OrbitIndex idx( cat, 72, 36 );
+
+    start = wall_time();
+    res.moved = idx.advance( 86400.0 / TU_SEC );
+    res.advance_s = wall_time() - start;
+
+    res.wrong = 0;
+
+    for ( int k = 0; k < n; k += 10 )
+    {
+        looked += idx.query( k, max_angle, max_phase, a );
+        found += a.size();
+        scan( idx, n, k, max_angle, max_phase, cat, b );
+        sort( a.begin(), a.end() );
+
+        if ( a != b )
+            res.wrong++;
+    }
+
+    res.looked = looked / ( ( n + 9 ) / 10 ) / n;
+    res.found = found / ( ( n + 9 ) / 10 );
+
+    total = 0;
+    start = wall_time();
+
+    for ( int p = 0; ( 0 == p ) || ( wall_time() - start < MIN_TIME ); p++ )
+    {
+        for ( int k = 0; k < n; k += 10 )
+            idx.query( k, max_angle, max_phase, a );
+
+        total += ( n + 9 ) / 10;
+    }
+
+    res.index_per_s = total / ( wall_time() - start );
+
+    total = 0;
+    start = wall_time();
+
+    for ( int p = 0; ( 0 == p ) || ( wall_time() - start < MIN_TIME ); p++ )
+    {
+        for ( int k = 0; k < n; k += 10 )
+            scan( idx, n, k, max_angle, max_phase, cat, b );
+
+        total += ( n + 9 ) / 10;
+    }
+
+    res.scan_per_s = total / ( wall_time() - start );
+    return res;
+}
+
+/**
+ * Print one result to the screen and, if there is one, the results file.
+ */
+static void
+report ( FILE* fpt, const char* who, const CatalogResult& res )
+{
+    const char* suite = "catalog";
+
+    printf( "%-10s %12.0f %12.0f %8.2f %10.2e %8d\n", who, res.traj_per_s,
+            res.catalog_per_s, res.catalog_per_s / res.traj_per_s,
+            res.err_max, res.failures );
+
+    if ( NULL == fpt )
+        return;
+
+    fprintf( fpt, "%s,%s,traj_per_s,%.6e\n", suite, who, res.traj_per_s );
+    fprintf( fpt, "%s,%s,catalog_per_s,%.6e\n", suite, who, res.catalog_per_s );
+    fprintf( fpt, "%s,%s,err_max,%.6e\n", suite, who, res.err_max );
+    fprintf( fpt, "%s,%s,failures,%d\n", suite, who, res.failures );
+}
+
+/**
+ * Print the index result to the screen and, if there is one, the results
+ * file.
+ */
+static void
+report_index ( FILE* fpt, const IndexResult& res )
+{
+    const char* suite = "index";
+    const char* who = "j2";
+
+    printf( "\nindex: advance a day %.2e s, %d moved; %.0f queries/s "
+            "(scan %.0f/s), looked at %.4f of the catalog, %.1f found, %d wrong\n",
+            res.advance_s, res.moved, res.index_per_s, res.scan_per_s,
+            res.looked, res.found, res.wrong );
+
+    if ( NULL == fpt )
+        return;
+
+    fprintf( fpt, "%s,%s,advance_s,%.6e\n", suite, who, res.advance_s );
+    fprintf( fpt, "%s,%s,moved,%d\n", suite, who, res.moved );
+    fprintf( fpt, "%s,%s,index_per_s,%.6e\n", suite, who, res.index_per_s );
+    fprintf( fpt, "%s,%s,scan_per_s,%.6e\n", suite, who, res.scan_per_s );
+    fprintf( fpt, "%s,%s,looked,%.6e\n", suite, who, res.looked );
+    fprintf( fpt, "%s,%s,found,%.6e\n", suite, who, res.found );
+    fprintf( fpt, "%s,%s,wrong,%d\n", suite, who, res.wrong );
+}
+
+int
+main ( int argc, char** argv )
+{
+    unsigned long seed = ( argc > 1 ) ? strtoul( argv[ 1 ], NULL, 10 ) : 1;
+    int objects = ( argc > 2 ) ? atoi( argv[ 2 ] ) : 20000;
+    FILE* fpt = NULL;
+
+    if ( ( argc > 4 ) || ( objects < 1 ) )
+    {
+        cerr << "Usage: catalog [seed [objects [results_file]]]" << endl;
+        exit( 1 );
+    }
+
+    if ( argc > 3 )
+    {
+        fpt = fopen( argv[ 3 ], "w" );
+
+        if ( NULL == fpt )
+        {
+            cerr << "ERROR: could not write " << argv[ 3 ] << endl;
+            exit( 1 );
+        }
+
+        fprintf( fpt, "# orbgnosis Catalog benchmark, built %s\n", VERSION_STRING );
+        fprintf( fpt, "# seed = %lu, objects = %d\n", seed, objects );
+        fprintf( fpt, "suite,propagator,metric,value\n" );
+    }
+
+    bench_seed( seed, 0 );
+    vector<Traj> t = make_catalog( objects );
+    Catalog cat;
+
+    for ( size_t k = 0; k < t.size(); k++ )
+        cat.add( t[ k ] );
+
+    printf( "seed = %lu, objects = %d, errors in km\n", seed, objects );
+    printf( "%-10s %12s %12s %8s %10s %8s\n", "propagator", "traj obj/s",
+            "catalog obj/s", "speedup", "err_max", "failed" );
+
+    target_propagator = PROPAGATE_TWO_BODY;
+    report( fpt, "two-body", run( t, cat ) );
+
+    target_propagator = PROPAGATE_SECULAR_J2;
+    report( fpt, "j2", run( t, cat ) );
+
+    report_index( fpt, run_index( cat ) );
+
+    if ( ( NULL != fpt ) && ( 0 != fclose( fpt ) ) )
+    {
+        cerr << "ERROR: could not write " << argv[ 3 ] << endl;
+        exit( 1 );
+    }
+
+    return 0;
+}
@@ -0,0 +1,316 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Exact tour search benchmark: Exhaustive and HeldKarp.
+ *
+ * Checks Exhaustive's fronts, for one objective (wsp1) and two (wsp2),
+ * against a plain search which costs every tour from scratch, and
+ * HeldKarp's against Exhaustive's, on random graphs of 4 to 9 nodes.
+ * Then times Exhaustive and HeldKarp on one graph each of 10 to 12 nodes,
+ * and the plain search on the 10 node graph, and HeldKarp alone on one
+ * graph each of 14 to 20 nodes.
+ *
+ *   graph [seed [cases [results_file]]]
+ *
+ * cases / 100 graphs of each size are checked.  The results file is CSV,
+ * one "suite,objectives,metric,value" record per line, so two runs can be
+ * compared with diff or a spreadsheet.
+ */
+
+#include "Vec3.h"
+#include "Bench.h"
+#include "Exhaustive.h"
+#include "Graph.h"
+#include "HeldKarp.h"
+#include "Timer.h"
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * A graph of n random nodes in a 100 by 100 square.
+ */
+static Graph
+make_graph ( int n )
+{
+    Graph g( n );
+
+    for ( int k = 0; k < n; k++ )
+        g.node[ k ] = Vec3( uniform( 0.0, 100.0 ), uniform( 0.0, 100.0 ), 0.0 );
+
+    g.find_costs();
+    return g;
+}
+
+/**
+ * The front the plain way: next_permutation() over nodes 1..n-1, each
+ * tour costed from scratch, as test_problem() does.
+ */
+static vector<ExhaustiveTour>
+plain ( const Graph& g, int nobj, const graph_cost* which, long long& tours )
+{
+    int n = g.numTargets;
+    vector<int> path( n );
+    vector<ExhaustiveTour> front;
+
+    for ( int k = 0; k < n; k++ )
+        path[ k ] = k;
+
+    tours = 0;
+
+    do
+    {
+        ExhaustiveTour t;
+        t.obj[ 0 ] = t.obj[ 1 ] = 0.0;
+
+        for ( int o = 0; o < nobj; o++ )
+            for ( int c = 0; c < n - 1; c++ )
+                t.obj[ o ] += g.get_cost( which[ o ], path[ c ], path[ c + 1 ] );
+
+        t.order = path;
+        tours++;
+
+        // Dominated, or a tie with a smaller order already there?
+        bool out = false;
+
+        for ( size_t f = 0; f < front.size(); f++ )
+            if ( ( front[ f ].obj[ 0 ] <= t.obj[ 0 ] ) && ( front[ f ].obj[ 1 ] <= t.obj[ 1 ] ) )
+                out = true;
+
+        if ( out )
+            continue;
+
+        vector<ExhaustiveTour> keep;
+
+        for ( size_t f = 0; f < front.size(); f++ )
+            if ( ! ( ( t.obj[ 0 ] <= front[ f ].obj[ 0 ] ) && ( t.obj[ 1 ] <= front[ f ].obj[ 1 ] ) ) )
+                keep.push_back( front[ f ] );
+
+        keep.push_back( t );
+        front = keep;
+    }
+    while ( next_permutation( path.begin() + 1, path.end() ) );
+
+    // next_permutation() goes in lexicographic order, so the first of
+    // any tie is already the one kept.
+    for ( size_t i = 0; i < front.size(); i++ )
+        for ( size_t j = i + 1; j < front.size(); j++ )
+            if ( front[ j ].obj[ 0 ] < front[ i ].obj[ 0 ] )
+                swap( front[ i ], front[ j ] );
+
+    return front;
+}
+
+/**
+ * Do two fronts cost the same, and is each tour of the second what it says
+ * it costs?  Ties may be broken differently, so the tours may differ.
+ */
+static bool
+same_costs ( const Graph& g, const graph_cost* which, int nobj,
+             const vector<ExhaustiveTour>& a, const vector<ExhaustiveTour>& b )
+{
+    if ( a.size() != b.size() )
+        return false;
+
+    for ( size_t k = 0; k < a.size(); k++ )
+        for ( int o = 0; o < nobj; o++ )
+        {
+            double total = 0.0;
+
+            for ( size_t c = 0; c + 1 < b[ k ].order.size(); c++ )
+                total += g.get_cost( which[ o ], b[ k ].order[ c ], b[ k ].order[ c + 1 ] );
+
+            if ( ( a[ k ].obj[ o ] != b[ k ].obj[ o ] ) || ( total != b[ k ].obj[ o ] ) )
+                return false;
+        }
+
+    return true;
+}
+
+/**
+ * Do two fronts hold the same tours?  Objectives may differ by roundoff.
+ */
+static bool
+same ( const vector<ExhaustiveTour>& a, const vector<ExhaustiveTour>& b )
+{
+    if ( a.size() != b.size() )
+        return false;
+
+    for ( size_t k = 0; k < a.size(); k++ )
+        if ( ( a[ k ].order != b[ k ].order )
+                || ( fabs( a[ k ].obj[ 0 ] - b[ k ].obj[ 0 ] ) > 1.0e-9 * a[ k ].obj[ 0 ] )
+                || ( fabs( a[ k ].obj[ 1 ] - b[ k ].obj[ 1 ] ) > 1.0e-9 * a[ k ].obj[ 1 ] ) )
+            return false;
+
+    return true;
+}
+
+int
+main ( int argc, char** argv )
+{
+    const graph_cost which[ 2 ][ 2 ] = { { COST_LENGTH, COST_LENGTH }, { COST_X, COST_Y } };
+    unsigned long seed = ( argc > 1 ) ? strtoul( argv[ 1 ], NULL, 10 ) : 1;
+    int cases = ( argc > 2 ) ? atoi( argv[ 2 ] ) : 2000;
+    int graphs = max( 1, cases / 100 );
+    FILE* fpt = NULL;
+
+    if ( ( argc > 4 ) || ( cases < 1 ) )
+    {
+        cerr << "Usage: graph [seed [cases [results_file]]]" << endl;
+        exit( 1 );
+    }
+
+    if ( argc > 3 )
+    {
+        fpt = fopen( argv[ 3 ], "w" );
+
+        if ( NULL == fpt )
+        {
+            cerr << "ERROR: could not write " << argv[ 3 ] << endl;
+            exit( 1 );
+        }
+
+        fprintf( fpt, "# orbgnosis Exhaustive benchmark, built %s\n", VERSION_STRING );
+        fprintf( fpt, "# seed = %lu, cases = %d\n", seed, cases );
+        fprintf( fpt, "suite,objectives,metric,value\n" );
+    }
+
+    printf( "seed = %lu, %d graphs of each size checked\n", seed, graphs );
+
+    for ( int nobj = 1; nobj <= 2; nobj++ )
+    {
+        int wrong = 0, hk_wrong = 0;
+
+        bench_seed( seed, nobj );
+
+        for ( int n = 4; n <= 9; n++ )
+            for ( int k = 0; k < graphs; k++ )
+            {
+                Graph g = make_graph( n );
+                Exhaustive ex( g, nobj, which[ nobj - 1 ] );
+                HeldKarp hk( g, nobj, which[ nobj - 1 ] );
+                long long tours;
+
+                ex.search();
+                hk.solve();
+
+                if ( ! same( ex.front, plain( g, nobj, which[ nobj - 1 ], tours ) )
+                        || ( ex.tours != tours ) )
+                    wrong++;
+
+                if ( ! same_costs( g, which[ nobj - 1 ], nobj, ex.front, hk.front ) )
+                    hk_wrong++;
+            }
+
+        printf( "%d objective(s): %d of %d Exhaustive fronts differ from the plain search, "
+                "%d HeldKarp fronts from Exhaustive\n", nobj, wrong, 6 * graphs, hk_wrong );
+
+        if ( NULL != fpt )
+        {
+            fprintf( fpt, "check,%d,wrong,%d\n", nobj, wrong );
+            fprintf( fpt, "check,%d,heldkarp_wrong,%d\n", nobj, hk_wrong );
+        }
+
+        for ( int n = 10; n <= 12; n++ )
+        {
+            Graph g = make_graph( n );
+            Exhaustive ex( g, nobj, which[ nobj - 1 ] );
+            double start = wall_time();
+
+            ex.search();
+
+            double elapsed = wall_time() - start;
+            printf( "  %2d nodes: %11lld tours in %8.3f s, %6.1f M tours/s, front of %d",
+                    n, ex.tours, elapsed, ex.tours / elapsed / 1.0e6, (int)ex.front.size() );
+
+            if ( NULL != fpt )
+            {
+                fprintf( fpt, "nodes_%d,%d,seconds,%.6e\n", n, nobj, elapsed );
+                fprintf( fpt, "nodes_%d,%d,tours_per_s,%.6e\n", n, nobj, ex.tours / elapsed );
+            }
+
+            if ( 10 == n )
+            {
+                long long tours;
+
+                start = wall_time();
+                plain( g, nobj, which[ nobj - 1 ], tours );
+                elapsed = wall_time() - start;
+                printf( " (plain %.1f M tours/s)", tours / elapsed / 1.0e6 );
+
+                if ( NULL != fpt )
+                    fprintf( fpt, "nodes_%d,%d,plain_tours_per_s,%.6e\n", n, nobj, tours / elapsed );
+            }
+
+            printf( "\n" );
+
+            HeldKarp hk( g, nobj, which[ nobj - 1 ] );
+            start = wall_time();
+            hk.solve();
+            elapsed = wall_time() - start;
+            printf( "            HeldKarp %8.3f s, %s\n", elapsed,
+                    same_costs( g, which[ nobj - 1 ], nobj, ex.front, hk.front )
+                    ? "same front" : "DIFFERENT FRONT" );
+
+            if ( NULL != fpt )
+                fprintf( fpt, "nodes_%d,%d,heldkarp_seconds,%.6e\n", n, nobj, elapsed );
+        }
+
+        for ( int n = 14; n <= ( ( 1 == nobj ) ? 20 : 16 ); n += 2 )
+        {
+            Graph g = make_graph( n );
+            HeldKarp hk( g, nobj, which[ nobj - 1 ] );
+            double start = wall_time();
+
+            hk.solve();
+
+            double elapsed = wall_time() - start;
+            printf( "  %2d nodes: HeldKarp %8.3f s, %lld states, %lld labels, front of %d\n",
+                    n, elapsed, hk.states, hk.labels, (int)hk.front.size() );
+
+            if ( NULL != fpt )
+                fprintf( fpt, "nodes_%d,%d,heldkarp_seconds,%.6e\n", n, nobj, elapsed );
+        }
+    }
+
+    if ( ( NULL != fpt ) && ( 0 != fclose( fpt ) ) )
+    {
+        cerr << "ERROR: could not write " << argv[ 3 ] << endl;
+        exit( 1 );
+    }
+
+    return 0;
+}
@@ -0,0 +1,467 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * kepler() accuracy and throughput benchmark.
+ *
+ * Propagates many orbits over many time spans and reports, per suite,
+ * calls per second, how often kepler() throws (and why), the iteration
+ * count distribution, relative drift of specific energy and angular
+ * momentum, and position error against an analytic reference (the same
+ * orbit at the mean anomaly Kepler's equation says it should reach,
+ * solved by Newton's method to machine precision).
+ *
+ * Suites, each generated from the same fixed seed:
+ *   elliptic       a 1.05 to 7 ER, e to 0.9, up to one period
+ *   nearparabolic  e within 0.01 of 1 either side, up to 10 TU
+ *   hyperbolic     e 1.1 to 3, up to 20 TU
+ *   multiperiod    LEO for 1 to 1e5 periods, and a to 100 ER for 1 to 100
+ *                  periods (the fmod() wrap)
+ *
+ * Then a check, not a benchmark: RK78 with J2 flies near circular LEO
+ * orbits for J2_ORBITS periods, and the node it ends up on must agree
+ * with the regression rate of Traj::find_J2_rates() to within J2_TOL.
+ * If it doesn't, kepler exits non-zero, and so does "make bench".
+ *
+ *   kepler [seed [cases [results_file]]]
+ *
+ * The results file is CSV, one "suite,propagator,metric,value" record
+ * per line, so two runs can be compared with diff or a spreadsheet.
+ */
+
+#include "Vec3.h"
+#include "Bench.h"
+#include "Kepler.h"
+#include "Orbgnosis.h"
+#include "RK78.h"
+#include "Timer.h"
+#include "Traj.h"
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+#define MAX_ITER 40     //!< kepler()'s iteration limit.
+#define J2_ORBITS 5     //!< periods flown by the J2 check.
+#define J2_CASES 20     //!< orbits in the J2 check.
+#define J2_TOL 0.02     //!< worst relative node regression error allowed.
+
+/**
+ * One propagation and its analytic answer.
+ */
+struct KeplerCase
+{
+    Traj start;     //!< initial state.
+    double t;       //!< time span.
+    Vec3 r;         //!< reference final position.
+};
+
+/**
+ * What kepler() did on one suite.
+ */
+struct KeplerResult
+{
+    int calls;              //!< cases attempted in the first pass.
+    int limit;              //!< threw 1, iteration limit.
+    int fg;                 //!< threw 2, F&G out of tolerance.
+    vector<int> iters;      //!< iterations of every call, sorted.
+    vector<double> energy;  //!< relative energy drift of good calls, sorted.
+    vector<double> h;       //!< relative angular momentum drift, sorted.
+    vector<double> err;     //!< position error (km) of good calls, sorted.
+    double calls_per_s;     //!< over all timed passes.
+};
+
+/**
+ * True anomaly at mean anomaly M, by Newton's method on Kepler's
+ * equation (elliptic) or its hyperbolic twin.
+ */
+static double
+true_anomaly ( double e, double M )
+{
+    double E, dE;
+
+    if ( e < 1.0 )
+    {
+        M = fmod( M, 2.0 * M_PI );
+        E = ( e < 0.8 ) ? M : M_PI;
+
+        for ( int k = 0; k < 200; k++ )
+        {
+            dE = ( E - e * sin( E ) - M ) / ( 1.0 - e * cos( E ) );
+            E -= dE;
+
+            if ( fabs( dE ) < 1.0e-15 )
+                break;
+        }
+
+        return 2.0 * atan2( sqrt( 1.0 + e ) * sin( 0.5 * E ),
+                            sqrt( 1.0 - e ) * cos( 0.5 * E ) );
+    }
+
+    E = asinh( M / e );
+
+    for ( int k = 0; k < 200; k++ )
+    {
+        dE = ( e * sinh( E ) - E - M ) / ( e * cosh( E ) - 1.0 );
+        E -= dE;
+
+        if ( fabs( dE ) < 1.0e-15 * ( 1.0 + fabs( E ) ) )
+            break;
+    }
+
+    return 2.0 * atan( sqrt( ( e + 1.0 ) / ( e - 1.0 ) ) * tanh( 0.5 * E ) );
+}
+
+/**
+ * Build a case from elements, propagated t time units.
+ */
+static KeplerCase
+make_case ( double a, double e, double f, double t )
+{
+    double i = uniform( 0.001, M_PI - 0.001 );
+    double raan = uniform( 0.0, 2.0 * M_PI );
+    double w = uniform( 0.0, 2.0 * M_PI );
+    KeplerCase kc;
+
+    kc.start = Traj( a, e, i, raan, w, f );
+    kc.t = t;
+    kc.r = Traj( a, e, i, raan, w,
+                 true_anomaly( e, kc.start.get_M() + t / sqrt( fabs( a * a * a ) ) ) ).get_r();
+    return kc;
+}
+
+/**
+ * Build a hyperbolic case with periapsis radius rp.
+ */
+static KeplerCase
+make_hyperbola ( double rp, double e, double t )
+{
+    double f_max = 0.8 * acos( -1.0 / e );  // stay clear of the asymptotes.
+    return make_case( rp / ( 1.0 - e ), e, uniform( -f_max, f_max ), t );
+}
+
+/**
+ * Generate the cases of one suite.
+ */
+static vector<KeplerCase>
+make_suite ( const char* suite, int cases )
+{
+    vector<KeplerCase> kc;
+
+    for ( int k = 0; k < cases; k++ )
+    {
+        if ( 0 == strcmp( suite, "elliptic" ) )
+        {
+            double a = uniform( 1.05, 7.0 );
+            double e = uniform( 0.0001, min( 0.9, 1.0 - 1.02 / a ) );
+            double period = 2.0 * M_PI * sqrt( a * a * a );
+            kc.push_back( make_case( a, e, uniform( 0.0, 2.0 * M_PI ),
+                                     uniform( 0.001, 1.0 ) * period ) );
+        }
+        else if ( 0 == strcmp( suite, "nearparabolic" ) )
+        {
+            double rp = uniform( 1.05, 2.0 );
+            double t = uniform( 0.1, 10.0 );
+
+            if ( k % 2 )
+                kc.push_back( make_hyperbola( rp, 1.0 + pow( 10.0, uniform( -4.0, -2.0 ) ), t ) );
+            else
+            {
+                double e = 1.0 - pow( 10.0, uniform( -4.0, -2.0 ) );
+                kc.push_back( make_case( rp / ( 1.0 - e ), e, uniform( -2.0, 2.0 ), t ) );
+            }
+        }
+        else if ( 0 == strcmp( suite, "hyperbolic" ) )
+        {
+            kc.push_back( make_hyperbola( uniform( 1.05, 3.0 ), uniform( 1.1, 3.0 ),
+                                          uniform( 0.1, 20.0 ) ) );
+        }
+        else
+        {
+            // Alternate LEO for a very long time with high, eccentric
+            // orbits for a few periods.
+            double a = ( k % 2 ) ? uniform( 1.05, 100.0 ) : uniform( 1.05, 1.5 );
+            double e = uniform( 0.0001, 1.0 - 1.02 / a );
+            double periods = pow( 10.0, ( k % 2 ) ? uniform( 0.0, 2.0 ) : uniform( 0.0, 5.0 ) );
+            kc.push_back( make_case( a, e, uniform( 0.0, 2.0 * M_PI ),
+                                     periods * 2.0 * M_PI * sqrt( a * a * a ) ) );
+        }
+    }
+
+    return kc;
+}
+
+/**
+ * Specific mechanical energy, and a scale to measure its drift against
+ * which doesn't vanish for near-parabolic orbits.
+ */
+static double
+energy ( Traj& traj, double* scale )
+{
+    double r = norm( traj.get_r() );
+    double v = norm( traj.get_v() );
+    *scale = 0.5 * v * v + 1.0 / r;
+    return 0.5 * v * v - 1.0 / r;
+}
+
+/**
+ * Run kepler() over one suite: a first pass for the statistics, then
+ * more timed passes until MIN_TIME has gone by.
+ */
+static KeplerResult
+run ( vector<KeplerCase>& kc )
+{
+    KeplerResult res;
+    Traj end;
+    int iters;
+    double scale;
+
+    res.calls = (int)kc.size();
+    res.limit = 0;
+    res.fg = 0;
+
+    double start = wall_time();
+
+    for ( size_t k = 0; k < kc.size(); k++ )
+    {
+        try
+        {
+            end = kepler( kc[ k ].start, kc[ k ].t, &iters );
+        }
+        catch ( int e )
+        {
+            res.iters.push_back( iters );
+
+            if ( 1 == e )
+                res.limit++;
+            else
+                res.fg++;
+
+            continue;
+        }
+
+        res.iters.push_back( iters );
+
+        double e0 = energy( kc[ k ].start, &scale );
+        res.energy.push_back( fabs( energy( end, &scale ) - e0 ) / scale );
+        res.h.push_back( norm( end.get_h_vector() - kc[ k ].start.get_h_vector() )
+                         / norm( kc[ k ].start.get_h_vector() ) );
+        res.err.push_back( ER * norm( end.get_r() - kc[ k ].r ) );
+    }
+
+    double elapsed = wall_time() - start;
+    long total = (long)kc.size();
+
+    while ( elapsed < MIN_TIME )
+    {
+        for ( size_t k = 0; k < kc.size(); k++ )
+        {
+            try
+            {
+                end = kepler( kc[ k ].start, kc[ k ].t );
+            }
+            catch ( int e )
+            {
+            }
+        }
+
+        total += (long)kc.size();
+        elapsed = wall_time() - start;
+    }
+
+    res.calls_per_s = total / elapsed;
+    sort( res.iters.begin(), res.iters.end() );
+    sort( res.energy.begin(), res.energy.end() );
+    sort( res.h.begin(), res.h.end() );
+    sort( res.err.begin(), res.err.end() );
+    return res;
+}
+
+/**
+ * Print one result to the screen and, if there is one, the results file.
+ */
+static void
+report ( FILE* fpt, const char* suite, const KeplerResult& res )
+{
+    const char* who = "kepler";
+    double mean_iter = 0.0;
+
+    for ( size_t k = 0; k < res.iters.size(); k++ )
+        mean_iter += res.iters[ k ];
+
+    mean_iter /= res.calls;
+
+    printf( "%-14s %10.0f %8.4f %8.4f %7.1f %5.0f %5.0f %10.2e %10.2e %10.2e %10.2e\n",
+            suite, res.calls_per_s,
+            (double)res.limit / res.calls, (double)res.fg / res.calls,
+            mean_iter, quantile( res.iters, 0.5 ), quantile( res.iters, 0.99 ),
+            quantile( res.energy, 0.99 ), quantile( res.h, 0.99 ),
+            quantile( res.err, 0.5 ), quantile( res.err, 1.0 ) );
+
+    if ( NULL == fpt )
+        return;
+
+    fprintf( fpt, "%s,%s,calls,%d\n", suite, who, res.calls );
+    fprintf( fpt, "%s,%s,calls_per_s,%.6e\n", suite, who, res.calls_per_s );
+    fprintf( fpt, "%s,%s,throw_limit,%d\n", suite, who, res.limit );
+    fprintf( fpt, "%s,%s,throw_fg,%d\n", suite, who, res.fg );
+    fprintf( fpt, "%s,%s,mean_iterations,%.6e\n", suite, who, mean_iter );
+    fprintf( fpt, "%s,%s,energy_drift_median,%.6e\n", suite, who, quantile( res.energy, 0.5 ) );
+    fprintf( fpt, "%s,%s,energy_drift_max,%.6e\n", suite, who, quantile( res.energy, 1.0 ) );
+    fprintf( fpt, "%s,%s,h_drift_median,%.6e\n", suite, who, quantile( res.h, 0.5 ) );
+    fprintf( fpt, "%s,%s,h_drift_max,%.6e\n", suite, who, quantile( res.h, 1.0 ) );
+    fprintf( fpt, "%s,%s,err_median,%.6e\n", suite, who, quantile( res.err, 0.5 ) );
+    fprintf( fpt, "%s,%s,err_p99,%.6e\n", suite, who, quantile( res.err, 0.99 ) );
+    fprintf( fpt, "%s,%s,err_max,%.6e\n", suite, who, quantile( res.err, 1.0 ) );
+
+    // The iteration histogram, from the sorted iteration counts.
+    for ( size_t k = 0; k < res.iters.size(); )
+    {
+        size_t n = upper_bound( res.iters.begin(), res.iters.end(), res.iters[ k ] )
+                   - res.iters.begin();
+        fprintf( fpt, "%s,%s,iterations_%d,%d\n", suite, who, res.iters[ k ], (int)( n - k ) );
+        k = n;
+    }
+}
+
+/**
+ * Fly near circular LEO orbits with RK78 and J2, and compare how far
+ * each node regresses with Traj::find_J2_rates().  The orbits are flown
+ * whole periods, so the short period terms mostly come back to where
+ * they started.
+ * @return the worst relative error of the node regression.
+ */
+static double
+j2_check ( FILE* fpt )
+{
+    RK78 truth( 1.0e-12, 0.0 );
+    vector<Vec3> r, v;
+    vector<double> t, raan, expect;
+    double worst = 0.0;
+
+    for ( int k = 0; k < J2_CASES; k++ )
+    {
+        double a = uniform( 1.05, 1.5 );
+        Traj start;
+
+        start.set_elorb( a, uniform( 0.0, 0.01 ), uniform( 0.2, 1.3 ),
+                         uniform( 0.0, 2.0 * M_PI ), uniform( 0.0, 2.0 * M_PI ),
+                         uniform( 0.0, 2.0 * M_PI ) );
+        r.push_back( start.get_r() );
+        v.push_back( start.get_v() );
+        t.push_back( J2_ORBITS * 2.0 * M_PI * a * sqrt( a ) );
+        raan.push_back( start.get_raan() );
+        expect.push_back( start.get_raan_dot() * t.back() );
+    }
+
+    truth.propagate( r, v, t );
+
+    for ( int k = 0; k < J2_CASES; k++ )
+    {
+        Traj end( r[ k ], v[ k ] );
+        double moved = remainder( end.get_raan() - raan[ k ], 2.0 * M_PI );
+        double err = fabs( moved / expect[ k ] - 1.0 );
+
+        if ( ! ( err <= worst ) )   // NaN is worst of all.
+            worst = err;
+    }
+
+    printf( "J2 check: RK78 node regression over %d orbits is within %.4f of "
+            "find_J2_rates() (tolerance %.4f)\n", J2_ORBITS, worst, J2_TOL );
+
+    if ( NULL != fpt )
+        fprintf( fpt, "j2,rk78,raan_error_max,%e\n", worst );
+
+    return worst;
+}
+
+int
+main ( int argc, char** argv )
+{
+    const char* suites[] = { "elliptic", "nearparabolic", "hyperbolic", "multiperiod" };
+    unsigned long seed = ( argc > 1 ) ? strtoul( argv[ 1 ], NULL, 10 ) : 1;
+    int cases = ( argc > 2 ) ? atoi( argv[ 2 ] ) : 2000;
+    FILE* fpt = NULL;
+
+    if ( ( argc > 4 ) || ( cases < 1 ) )
+    {
+        cerr << "Usage: kepler [seed [cases [results_file]]]" << endl;
+        exit( 1 );
+    }
+
+    if ( argc > 3 )
+    {
+        fpt = fopen( argv[ 3 ], "w" );
+
+        if ( NULL == fpt )
+        {
+            cerr << "ERROR: could not write " << argv[ 3 ] << endl;
+            exit( 1 );
+        }
+
+        fprintf( fpt, "# orbgnosis kepler() benchmark, built %s\n", VERSION_STRING );
+        fprintf( fpt, "# seed = %lu, cases = %d\n", seed, cases );
+        fprintf( fpt, "suite,propagator,metric,value\n" );
+    }
+
+    printf( "seed = %lu, cases per suite = %d, drifts are relative, errors in km\n", seed, cases );
+    printf( "%-14s %10s %8s %8s %7s %5s %5s %10s %10s %10s %10s\n", "suite",
+            "calls/s", "limit", "F&G", "iter", "p50", "p99",
+            "dE_p99", "dh_p99", "err_p50", "err_max" );
+
+    for ( int s = 0; s < 4; s++ )
+    {
+        bench_seed( seed, s );
+        vector<KeplerCase> kc = make_suite( suites[ s ], cases );
+        report( fpt, suites[ s ], run( kc ) );
+    }
+
+    bench_seed( seed, 4 );
+    bool j2_ok = ( j2_check( fpt ) <= J2_TOL );
+
+    if ( ( NULL != fpt ) && ( 0 != fclose( fpt ) ) )
+    {
+        cerr << "ERROR: could not write " << argv[ 3 ] << endl;
+        exit( 1 );
+    }
+
+    if ( ! j2_ok )
+    {
+        cerr << "ERROR: RK78 J2 disagrees with find_J2_rates()" << endl;
+        return 1;
+    }
+
+    return 0;
+}
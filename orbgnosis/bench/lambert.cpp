@@ -0,0 +1,398 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Lambert solver benchmark and convergence profile.
+ *
+ * Every case is built from a known transfer orbit: two true anomalies on
+ * it give the end points, and Kepler's equation gives the exact time of
+ * flight between them (plus whole periods for multi-rev cases).  The
+ * velocities of that orbit at the end points are the reference solution,
+ * good to a few ulps, so solver error is measured directly rather than
+ * against another iterative solver.
+ *
+ * Suites, each generated from the same fixed seed:
+ *   leo      LEO to LEO, transfer angle 5 to 355 degrees, away from 180
+ *   near0    transfer angle within 0.1 to 1e-6 rad of 0 or 360 degrees
+ *   near180  transfer angle within 0.1 to 1e-6 rad of 180 degrees
+ *   multirev 1 to 3 complete revolutions (ULambert only)
+ *   legs     zero-rev legs like the ones wsp_astro prices, see make_leg()
+ *
+ * For each suite and solver it reports solves per second, failures (the
+ * solver said so), wrong answers (converged, but more than WRONG m/s off,
+ * e.g. the other multi-rev branch), velocity error quantiles of the
+ * right answers, and a histogram of iteration counts.
+ *
+ *   lambert [seed [cases [results_file]]]
+ *
+ * The results file is CSV, one "suite,solver,metric,value" record per
+ * line, so two runs can be compared with diff or a spreadsheet.
+ */
+
+#include "Vec3.h"
+#include "Bench.h"
+#include "BLambert.h"
+#include "Orbgnosis.h"
+#include "Timer.h"
+#include "Traj.h"
+#include "ULambert.h"
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+#define WRONG 1.0       //!< m/s; a converged answer further off than this is wrong.
+#define MAX_ITER 64     //!< histogram bins; both solvers stop well before this.
+
+/**
+ * One Lambert problem and its reference solution.
+ */
+struct LambertCase
+{
+    Vec3 r1, r2;    //!< end points.
+    Vec3 v1, v2;    //!< reference velocities at the end points.
+    double tof;     //!< time of flight.
+    bool longway;   //!< transfer angle is more than pi.
+    int revs;       //!< complete revolutions.
+};
+
+/**
+ * What one solver did on one suite.
+ */
+struct LambertResult
+{
+    int solves;             //!< cases attempted in the first pass.
+    int failures;           //!< the solver reported failure.
+    int wrong;              //!< converged, but not to the reference.
+    vector<double> err;     //!< velocity error (m/s) of the right answers.
+    vector<int> hist;       //!< iteration count histogram.
+    double solves_per_s;    //!< over all timed passes.
+};
+
+/**
+ * Build a case on the given transfer orbit, from true anomaly f1 through
+ * dnu radians plus revs complete revolutions.
+ */
+static LambertCase
+orbit_case ( double a, double e, double i, double raan, double w,
+             double f1, double dnu, int revs )
+{
+    LambertCase lc;
+    double f2 = fmod( f1 + dnu, 2.0 * M_PI );
+
+    Traj start( a, e, i, raan, w, f1 );
+    Traj end( a, e, i, raan, w, f2 );
+
+    double dM = fmod( end.get_M() - start.get_M(), 2.0 * M_PI );
+
+    if ( dM < 0.0 )
+        dM += 2.0 * M_PI;
+
+    lc.r1 = start.get_r();
+    lc.v1 = start.get_v();
+    lc.r2 = end.get_r();
+    lc.v2 = end.get_v();
+    lc.tof = ( dM + 2.0 * M_PI * revs ) * sqrt( a * a * a );
+    lc.longway = ( dnu > M_PI );
+    lc.revs = revs;
+    return lc;
+}
+
+/**
+ * Build a case on a random LEO-ish transfer orbit, sweeping dnu radians.
+ */
+static LambertCase
+make_case ( double dnu, int revs )
+{
+    double a = uniform( 1.05, 1.3 );
+    double e = uniform( 0.0001, 1.0 - 1.03 / a );  // perigee above 1.03 ER
+    double i = uniform( 0.001, M_PI - 0.001 );
+    double raan = uniform( 0.0, 2.0 * M_PI );
+    double w = uniform( 0.0, 2.0 * M_PI );
+    double f1 = uniform( 0.0, 2.0 * M_PI );
+
+    return orbit_case( a, e, i, raan, w, f1, dnu, revs );
+}
+
+/**
+ * Build a case like a zero-rev leg of the wsp_astro tour: phasing within
+ * the plane of the constellation set up in Orbgnosis.cpp (a = 1.106,
+ * e = 0.0035, i = 85 degrees), on a nearly circular transfer orbit.  The
+ * shortest legs the GA tries are 0.1 TU, about 5 degrees of arc, and the
+ * longest sweep all the way around, so both 180 and 360 degrees turn up.
+ */
+static LambertCase
+make_leg ( void )
+{
+    double a = uniform( 1.08, 1.13 );
+    double e = uniform( 0.0001, 0.03 );
+    double w = uniform( 0.0, 2.0 * M_PI );
+    double f1 = uniform( 0.0, 2.0 * M_PI );
+    double dnu = uniform( 0.085, 2.0 * M_PI );
+
+    return orbit_case( a, e, 1.4835298642, 0.872664626, w, f1, dnu, 0 );
+}
+
+/**
+ * A transfer angle 0.1 to 1e-6 rad away from "center", on either side.
+ */
+static double
+near ( double center )
+{
+    double offset = pow( 10.0, uniform( -6.0, -1.0 ) );
+    return ( uniform( 0.0, 1.0 ) < 0.5 ) ? center - offset : center + offset;
+}
+
+/**
+ * Generate the cases of one suite.
+ */
+static vector<LambertCase>
+make_suite ( const char* suite, int cases )
+{
+    vector<LambertCase> lc;
+    double dnu;
+
+    for ( int k = 0; k < cases; k++ )
+    {
+        if ( 0 == strcmp( suite, "near0" ) )
+        {
+            dnu = near( 0.0 );
+            if ( dnu < 0.0 )
+                dnu += 2.0 * M_PI;  // just short of 360 degrees.
+
+            lc.push_back( make_case( dnu, 0 ) );
+        }
+        else if ( 0 == strcmp( suite, "near180" ) )
+        {
+            lc.push_back( make_case( near( M_PI ), 0 ) );
+        }
+        else if ( 0 == strcmp( suite, "legs" ) )
+        {
+            lc.push_back( make_leg() );
+        }
+        else
+        {
+            // Keep clear of 180 degrees, that's what near180 is for.
+            do
+                dnu = uniform( 5.0, 355.0 ) * M_PI / 180.0;
+            while ( fabs( dnu - M_PI ) < 5.0 * M_PI / 180.0 );
+
+            int revs = ( 0 == strcmp( suite, "multirev" ) ) ? 1 + k % 3 : 0;
+            lc.push_back( make_case( dnu, revs ) );
+        }
+    }
+
+    return lc;
+}
+
+/**
+ * Velocity error of a solution, m/s.  INF if it isn't finite.
+ */
+static double
+velocity_error ( const LambertCase& lc, Vec3 Vo, Vec3 V )
+{
+    double err = ERTU * max( norm( Vo - lc.v1 ), norm( V - lc.v2 ) );
+    return ( err == err ) && ( err < INF ) ? err : INF;
+}
+
+/**
+ * Solve one case with the universal variables solver.
+ */
+static void
+solve ( ULambert& xfer, const LambertCase& lc )
+{
+    xfer.setRo( lc.r1 );
+    xfer.setR( lc.r2 );
+    xfer.sett( lc.tof );
+    // universal()'s bisection bounds count half revolutions.
+    xfer.universal( lc.longway, 2 * lc.revs );
+}
+
+/**
+ * Solve one case with Battin's method.  It has no multi-rev option, so
+ * it is only run on zero-rev suites.
+ */
+static void
+solve ( BLambert& xfer, const LambertCase& lc )
+{
+    xfer.setRo( lc.r1 );
+    xfer.setR( lc.r2 );
+    xfer.sett( lc.tof );
+    xfer.battin( lc.longway );
+}
+
+/**
+ * Run one solver over one suite: a first pass for the statistics, then
+ * more timed passes until MIN_TIME has gone by.
+ */
+template <class Solver> static LambertResult
+run ( const vector<LambertCase>& lc )
+{
+    Solver xfer;
+    LambertResult res;
+
+    res.solves = (int)lc.size();
+    res.failures = 0;
+    res.wrong = 0;
+    res.hist.assign( MAX_ITER + 1, 0 );
+
+    double start = wall_time();
+
+    for ( size_t k = 0; k < lc.size(); k++ )
+    {
+        solve( xfer, lc[ k ] );
+        res.hist[ min( xfer.getIterations(), MAX_ITER ) ]++;
+
+        if ( xfer.isFailure() )
+        {
+            res.failures++;
+            continue;
+        }
+
+        double err = velocity_error( lc[ k ], xfer.getVo(), xfer.getV() );
+
+        if ( err > WRONG )
+            res.wrong++;
+        else
+            res.err.push_back( err );
+    }
+
+    double elapsed = wall_time() - start;
+    long total = (long)lc.size();
+
+    while ( elapsed < MIN_TIME )
+    {
+        for ( size_t k = 0; k < lc.size(); k++ )
+            solve( xfer, lc[ k ] );
+
+        total += (long)lc.size();
+        elapsed = wall_time() - start;
+    }
+
+    res.solves_per_s = total / elapsed;
+    sort( res.err.begin(), res.err.end() );
+    return res;
+}
+
+/**
+ * Print one result to the screen and, if there is one, the results file.
+ */
+static void
+report ( FILE* fpt, const char* suite, const char* solver, const LambertResult& res )
+{
+    double mean_iter = 0.0;
+
+    for ( int k = 0; k <= MAX_ITER; k++ )
+        mean_iter += k * res.hist[ k ];
+
+    mean_iter /= res.solves;
+
+    printf( "%-9s %-10s %12.0f %9.4f %9.4f %8.2f %11.3e %11.3e %11.3e\n",
+            suite, solver, res.solves_per_s,
+            (double)res.failures / res.solves, (double)res.wrong / res.solves,
+            mean_iter, quantile( res.err, 0.5 ), quantile( res.err, 0.99 ),
+            quantile( res.err, 1.0 ) );
+
+    if ( NULL == fpt )
+        return;
+
+    fprintf( fpt, "%s,%s,solves,%d\n", suite, solver, res.solves );
+    fprintf( fpt, "%s,%s,solves_per_s,%.6e\n", suite, solver, res.solves_per_s );
+    fprintf( fpt, "%s,%s,failures,%d\n", suite, solver, res.failures );
+    fprintf( fpt, "%s,%s,wrong,%d\n", suite, solver, res.wrong );
+    fprintf( fpt, "%s,%s,mean_iterations,%.6e\n", suite, solver, mean_iter );
+    fprintf( fpt, "%s,%s,err_median,%.6e\n", suite, solver, quantile( res.err, 0.5 ) );
+    fprintf( fpt, "%s,%s,err_p99,%.6e\n", suite, solver, quantile( res.err, 0.99 ) );
+    fprintf( fpt, "%s,%s,err_max,%.6e\n", suite, solver, quantile( res.err, 1.0 ) );
+
+    for ( int k = 0; k <= MAX_ITER; k++ )
+        if ( res.hist[ k ] > 0 )
+            fprintf( fpt, "%s,%s,iterations_%d,%d\n", suite, solver, k, res.hist[ k ] );
+}
+
+int
+main ( int argc, char** argv )
+{
+    const char* suites[] = { "leo", "near0", "near180", "multirev", "legs" };
+    unsigned long seed = ( argc > 1 ) ? strtoul( argv[ 1 ], NULL, 10 ) : 1;
+    int cases = ( argc > 2 ) ? atoi( argv[ 2 ] ) : 2000;
+    FILE* fpt = NULL;
+
+    if ( ( argc > 4 ) || ( cases < 1 ) )
+    {
+        cerr << "Usage: lambert [seed [cases [results_file]]]" << endl;
+        exit( 1 );
+    }
+
+    if ( argc > 3 )
+    {
+        fpt = fopen( argv[ 3 ], "w" );
+
+        if ( NULL == fpt )
+        {
+            cerr << "ERROR: could not write " << argv[ 3 ] << endl;
+            exit( 1 );
+        }
+
+        fprintf( fpt, "# orbgnosis Lambert benchmark, built %s\n", VERSION_STRING );
+        fprintf( fpt, "# seed = %lu, cases = %d, wrong = %g m/s\n", seed, cases, WRONG );
+        fprintf( fpt, "suite,solver,metric,value\n" );
+    }
+
+    printf( "seed = %lu, cases per suite = %d, velocity errors in m/s\n", seed, cases );
+    printf( "%-9s %-10s %12s %9s %9s %8s %11s %11s %11s\n", "suite", "solver",
+            "solves/s", "failed", "wrong", "iter", "err_median", "err_p99", "err_max" );
+
+    for ( int s = 0; s < 5; s++ )
+    {
+        // Each suite has its own stream from the seed, so adding a suite
+        // doesn't change the cases of the others.
+        bench_seed( seed, s );
+        vector<LambertCase> lc = make_suite( suites[ s ], cases );
+
+        report( fpt, suites[ s ], "universal", run<ULambert>( lc ) );
+
+        if ( 0 != strcmp( suites[ s ], "multirev" ) )
+            report( fpt, suites[ s ], "battin", run<BLambert>( lc ) );
+    }
+
+    if ( ( NULL != fpt ) && ( 0 != fclose( fpt ) ) )
+    {
+        cerr << "ERROR: could not write " << argv[ 3 ] << endl;
+        exit( 1 );
+    }
+
+    return 0;
+}
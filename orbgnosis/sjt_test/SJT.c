@@ -13,9 +13,25 @@
 /* http://theory.cs.uvic.ca/inf/perm/PermInfo.html                    */
 /*===================================================================*/
 
+/*
+ * Orbgnosis: this generates the tour tables in data/.  By default it
+ * writes the packed binary format described in src/TourTable.h, which Tour
+ * memory-maps.  With -t it writes the old one-digit-per-node text format.
+ *
+ *   SJT 7 > data/7.tbl
+ *   SJT -t 7 > data/7.dat
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/TourTable.h"
+
 int  NN, i, count=0 ;
 int  p[100], pi[100];   /* The permutation and its inverse */
 int  dir[100];          /* The directions of each element  */
+int  text = 0;          /* 1 for the old text output */
+unsigned char row[TOUR_TABLE_MAXCOLS / 2];  /* one packed row */
 
 void PrintPerm() {
   int i;
@@ -24,13 +40,20 @@ void PrintPerm() {
      count = count + 1;
      printf( "[%8d] ", count ); 
   */
-  printf("0");
-  for (i=1; i <= NN; ++i) printf( "%d", p[i] );
+  if (text) {
+    printf("0");
+    for (i=1; i <= NN; ++i) printf( "%d", p[i] );
+    return;
+  }
+  memset(row, 0, sizeof(row));
+  tour_table_set(row, 0, 0);
+  for (i=1; i <= NN; ++i) tour_table_set(row, i, p[i]);
+  fwrite(row, 1, tour_table_row_bytes(NN + 1), stdout);
 } /* PrintPerm */;
 
 void PrintTrans( int x, int y ) {
   /*printf( "    (%d %d)", x, y );*/
-  printf( "\n" );
+  if (text) printf( "\n" );
 } /* PrintTrans */;
 
 void Move( int x, int d ) {
@@ -55,16 +78,42 @@ void Perm ( int n ) {
   }
 } /* of Perm */;
 
+void PrintHeader() {
+  tour_table_header h;
+  uint32_t rows = 1;
+  int k;
+  for (k=2; k <= NN; ++k) rows *= k;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, TOUR_TABLE_MAGIC, 4);
+  h.version = TOUR_TABLE_VERSION;
+  h.cols = NN + 1;
+  h.rows = rows;
+  h.row_bytes = tour_table_row_bytes(NN + 1);
+  fwrite(&h, sizeof(h), 1, stdout);
+} /* PrintHeader */;
+
 int main (int argc, char **argv) {
-  if (argc < 2)
+  int a = 1;
+  if (argc > 1 && strcmp(argv[1], "-t") == 0) {
+    text = 1;
+    a++;
+  }
+  if (argc <= a)
+  {
+    printf ("\nUsage: SJT [-t] n, n an integer 1-%d.\n", TOUR_TABLE_MAXTARGETS);
+    exit(1);
+  }
+  NN = (int)atoi(argv[a]);
+  if (NN < 1 || NN > TOUR_TABLE_MAXTARGETS)
   {
-    printf ("\nUsage: enter integer 1-9.\n");
+    fprintf (stderr, "SJT: n must be 1-%d.\n", TOUR_TABLE_MAXTARGETS);
     exit(1);
   }
-  NN = (int)atoi(argv[1]);
+  if (!text) PrintHeader();
   for (i=1; i<=NN; ++i) {
     dir[i] = -1;  p[i] = i;  pi[i] = i;
   }
   Perm ( 1 );
-  printf( "\n" );
+  if (text) printf( "\n" );
+  return 0;
 }
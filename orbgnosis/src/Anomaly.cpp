@@ -0,0 +1,163 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include "Anomaly.h"
+#include "Orbgnosis.h"
+#include <math.h>
+
+/*
+ * Every lane takes the same, fixed number of iterations, whatever its
+ * eccentricity or mean anomaly, so the loops have no data-dependent
+ * branches or exits and the compiler is free to vectorize them.  The
+ * counts give roundoff-level residuals from the starters below over
+ * 0 <= e <= 1 - 1e-6 for every M, and 1 + 1e-4 <= e <= 100 for
+ * 1e-6 <= |M| <= 1e5, with a step to spare for open orbits.
+ */
+#define ELLIPTIC_ITERATIONS 1    //!< fifth order steps for e < 1.
+#define HYPERBOLIC_ITERATIONS 3  //!< Halley steps for e > 1.
+
+/**
+ * Solve Kepler's equation for the eccentric anomaly, E - e sin(E) = M, or
+ * for the hyperbolic anomaly, e sinh(H) - H = M, or for the parabolic
+ * anomaly, D + D^3 / 3 = M (Barker's equation, e = 1).
+ * E comes back in the same revolution as M.
+ * @param n how many anomalies to solve.
+ * @param M mean anomalies (radians).
+ * @param e eccentricities, >= 0.
+ * @param E gets the eccentric, hyperbolic or parabolic anomalies.
+ */
+void
+mean_to_eccentric ( int n, const double* M, const double* e, double* E )
+{
+    // Elliptic lanes.  M is reduced to [-pi, pi] and the starter is
+    // Mikkola's cubic approximation ("A Cubic Approximation for Kepler's
+    // Equation", 1987), good to about 1e-3 rad even where e approaches 1
+    // and M approaches 0.  Each step is a fifth order correction built
+    // from one sine and cosine (Danby's nested form), so one is enough.
+    #pragma omp simd
+    for ( int k = 0; k < n; k++ )
+    {
+        double ek = ( e[ k ] < 1.0 ) ? e[ k ] : 0.0;
+        double q = M[ k ] / ( 2.0 * M_PI );
+        double turns = 2.0 * M_PI * (double)(long)( q + copysign( 0.5, q ) );
+        double m = M[ k ] - turns;
+        double alpha = ( 1.0 - ek ) / ( 4.0 * ek + 0.5 );
+        double beta = 0.5 * m / ( 4.0 * ek + 0.5 );
+        double z = cbrt( beta + copysign( sqrt( beta * beta + alpha * alpha * alpha ), beta ) );
+        double sz = ( z != 0.0 ) ? z - alpha / z : 0.0;
+        double x;
+
+        sz -= 0.078 * sz * sz * sz * sz * sz / ( 1.0 + ek );
+        x = m + ek * sz * ( 3.0 - 4.0 * sz * sz );
+
+        for ( int it = 0; it < ELLIPTIC_ITERATIONS; it++ )
+        {
+            double es = ek * sin( x );
+            double ec = ek * cos( x );
+            double f0 = x - es - m;
+            double f1 = 1.0 - ec;
+            double u = -f0 / f1;
+
+            u = -f0 / ( f1 + 0.5 * es * u );
+            u = -f0 / ( f1 + 0.5 * es * u + ec * u * u / 6.0 );
+            u = -f0 / ( f1 + 0.5 * es * u + ec * u * u / 6.0
+                        - es * u * u * u / 24.0 );
+            u = -f0 / ( f1 + 0.5 * es * u + ec * u * u / 6.0
+                        - es * u * u * u / 24.0 - ec * u * u * u * u / 120.0 );
+            x += u;
+        }
+
+        E[ k ] = x + turns;
+    }
+
+    // Open orbits are rarer; their lanes are redone here.
+    for ( int k = 0; k < n; k++ )
+    {
+        if ( e[ k ] < 1.0 )
+            continue;
+
+        if ( e[ k ] == 1.0 )
+        {
+            // Barker's equation has a closed form solution.
+            double b = 1.5 * M[ k ];
+            double s = cbrt( b + sqrt( b * b + 1.0 ) );
+            E[ k ] = s - 1.0 / s;
+            continue;
+        }
+
+        // Hyperbolic, with Mikkola's hyperbolic starter.
+        double m = M[ k ];
+        double ek = e[ k ];
+        double alpha = ( ek - 1.0 ) / ( 4.0 * ek + 0.5 );
+        double beta = 0.5 * m / ( 4.0 * ek + 0.5 );
+        double z = cbrt( beta + copysign( sqrt( beta * beta + alpha * alpha * alpha ), beta ) );
+        double sz = ( z != 0.0 ) ? z - alpha / z : 0.0;
+        double x;
+
+        sz += 0.071 * sz * sz * sz * sz * sz / ( ( 1.0 + 0.45 * sz * sz ) * ( 1.0 + 4.0 * sz * sz ) * ek );
+        x = 3.0 * asinh( sz );
+
+        for ( int it = 0; it < HYPERBOLIC_ITERATIONS; it++ )
+        {
+            double es = ek * sinh( x );
+            double ec = ek * cosh( x );
+            double f0 = es - x - m;
+            double f1 = ec - 1.0;
+            x -= f0 * f1 / ( f1 * f1 - 0.5 * f0 * es );
+        }
+
+        E[ k ] = x;
+    }
+}
+
+/**
+ * Solve Kepler's equation for the true anomaly.  See mean_to_eccentric().
+ * @param n how many anomalies to solve.
+ * @param M mean anomalies (radians).
+ * @param e eccentricities, >= 0.
+ * @param f gets the true anomalies, in [-pi, pi].
+ */
+void
+mean_to_true ( int n, const double* M, const double* e, double* f )
+{
+    mean_to_eccentric( n, M, e, f );
+
+    for ( int k = 0; k < n; k++ )
+    {
+        if ( e[ k ] < 1.0 )
+            f[ k ] = 2.0 * atan2( sqrt( 1.0 + e[ k ] ) * sin( 0.5 * f[ k ] ),
+                                  sqrt( 1.0 - e[ k ] ) * cos( 0.5 * f[ k ] ) );
+        else if ( e[ k ] == 1.0 )
+            f[ k ] = 2.0 * atan( f[ k ] );
+        else
+            f[ k ] = 2.0 * atan( sqrt( ( e[ k ] + 1.0 ) / ( e[ k ] - 1.0 ) )
+                                 * tanh( 0.5 * f[ k ] ) );
+    }
+}
@@ -49,7 +49,8 @@ BLambert::BLambert( void ) :
         R( 0.0, 0.0, 0.0 ),
         Vo( 0.0, 0.0, 0.0 ),
         V( 0.0, 0.0, 0.0 ),
-        failure( false )
+        failure( false ),
+        iterations( 0 )
 {
     //cout << "BLambert constructor called with no args.\n";
 }
@@ -66,7 +67,8 @@ BLambert::BLambert( Vec3 r1in, Vec3 r2in, double tin ) :
         R( r2in ),
         Vo( 0.0, 0.0, 0.0 ),
         V( 0.0, 0.0, 0.0 ),
-        failure( false )
+        failure( false ),
+        iterations( 0 )
 {
     //cout << "BLambert constructor called with 2 vectors and 1 time.\n";
 }
@@ -155,23 +157,47 @@ BLambert::isFailure( void )
     }
 }
 
+/**
+ * Gets the number of iterations used by the last solution.
+ */
+int
+BLambert::getIterations( void )
+{
+    return iterations;
+}
+
 /**
  * Solves Lamberts Problem using Battin's Method.
  * Adapted from David Vallado's Ada implementation in  "Fundamentals of
- * Astrodynamics and Applications"
+ * Astrodynamics and Applications", and checked against Battin's
+ * "An Introduction to the Mathematics and Methods of Astrodynamics".
+ * Only zero-revolution transfers are found.
+ * @param Lin true for the "long way", a swept angle greater than pi.
  */
 void
-BLambert::battin ( void )
+BLambert::battin ( const bool Lin )
 {
+    /// True if desired solution is to be the "long way", e.g.
+    /// the swept angle is greater than pi or 180 degrees.
+    const bool longway = Lin;
+
+    /// The maximum number of iterations allowed.
+    const int NumIter = 30;
+
     // Local variables
     int Loops;
     Vec3 RCrossR;
-    double u, b, Sinv, Cosv, rp, x, xn, y, L, m, CosDeltaNu,
-    SinDeltaNu, DNu, a, tan2w, RoR, h1, h2, tempx, eps,
-    denom, chord, k2, s, f, g, fDot, am, ae, be, tm, gDot,
-    arg1, arg2, AlpE, AlpH, BetE, BetH, DE, DH, sqdnu;
+    double u, b, Sinv, rp, x, xn, y, L, m, CosDeltaNu,
+    SinDeltaNu, DNu, a, tan2w, RoR, tempx, eps,
+    denom, chord, k2, s, f, g, gDot, h1, h2,
+    am, be, tm, AlpE, BetE, DE, AlpH, BetH, DH, p, q;
     double Ro4, R4;
 
+    failure = false;
+    iterations = 0;
+    Vo.toZero();
+    V.toZero();
+
     // initialize values
     // Magnitudes of Ro and R
     Ro4 = norm( Ro );
@@ -180,33 +206,37 @@ BLambert::battin ( void )
     CosDeltaNu = dot( Ro, R ) / ( Ro4 * R4 );
     RCrossR = cross( Ro, R );
     SinDeltaNu = norm( RCrossR ) / ( Ro4 * R4 );
-    DNu = atan2( SinDeltaNu, CosDeltaNu ); // quadrant safe
+    DNu = atan2( SinDeltaNu, CosDeltaNu ); // quadrant safe, 0 to pi
+
+    if ( true == longway )
+        DNu = 2.0 * M_PI - DNu;
 
     RoR = R4 / Ro4;
-    eps = RoR / 1.0;
+    eps = RoR - 1.0;
     tan2w = 0.25 * eps * eps / ( sqrt( RoR ) + RoR * ( 2.0 + sqrt ( RoR ) ) );
     rp = sqrt( Ro4 * R4 ) * ( cos( 0.25 * DNu ) * cos( 0.25 * DNu ) + tan2w );
 
     if ( DNu < M_PI )
     {
-        sqdnu = sin( 0.25 * DNu ) * sin ( 0.25 * DNu );
-        L = ( sqdnu + tan2w ) / ( sqdnu + tan2w + cos ( 0.5 * DNu ) );
+        Sinv = sin( 0.25 * DNu ) * sin ( 0.25 * DNu );
+        L = ( Sinv + tan2w ) / ( Sinv + tan2w + cos ( 0.5 * DNu ) );
     }
 
     else
     {
-        sqdnu = cos( 0.25 * DNu ) * sin ( 0.25 * DNu );
-        L = ( sqdnu + tan2w - cos( 0.5 * DNu ) ) / ( sqdnu + tan2w );
+        Sinv = cos( 0.25 * DNu ) * cos ( 0.25 * DNu );
+        L = ( Sinv + tan2w - cos( 0.5 * DNu ) ) / ( Sinv + tan2w );
     }
 
     m = t * t / ( 8.0 * rp * rp * rp ); // t is time of flight
-    xn = 0.0;                          // 0 for parabolic and hyperbolic
+    xn = L;                             // Battin's starting guess
+    y = 1.0;
     chord = sqrt( Ro4 * Ro4 + R4 * R4 - 2.0 * Ro4 * R4 * cos( DNu ) );
     s = 0.5 * ( Ro4 + R4 + chord );
 
-    Loops = 1;
+    Loops = 0;
 
-    while ( Loops < 30 )
+    while ( Loops < NumIter )
     {
         x = xn;
         tempx = bat_SEE( x );
@@ -224,46 +254,115 @@ BLambert::battin ( void )
         xn = sqrt( ( 0.5 * ( 1.0 - L ) ) * ( 0.5 * ( 1.0 - L ) ) + m / ( y * y ) )
              - 0.5 * ( 1.0 + L );
 
-        if ( fabs( xn - x ) < SMALL )
-            break; // XXX ugly
-
         Loops = Loops + 1;
+
+        if ( fabs( xn - x ) < SMALL * SMALL * ( 1.0 + fabs( x ) ) )
+            break; // XXX ugly
     } // end while loop
 
-    a = t * t / ( 16.0 * rp * rp * xn * y * y );
+    iterations = Loops;
+
+    if ( ( fabs( xn - x ) >= SMALL * ( 1.0 + fabs( x ) ) ) || ! ( xn == xn ) )
+    {
+        // cout << "Error: Lambert Battin failed to converge. \n";
+        Vo.toInf();
+        V.toInf();
+        failure = true;
+        return;
+    }
+
+    // Find the Lagrange f and g functions.
+    // 1/a is proportional to x, so a parabola has x = 0.
+    if ( fabs( 16.0 * rp * rp * xn * y * y * s / ( t * t ) ) < SMALL )
+    {
+        // Parabolic: a is infinite, so use the semiparameter instead.
+        q = ( true == longway ) ? sqrt( s ) - sqrt( s - chord )
+            : sqrt( s ) + sqrt( s - chord );
+        p = 2.0 * ( s - Ro4 ) * ( s - R4 ) * q * q / ( chord * chord );
+        f = 1.0 - ( R4 / p ) * ( 1.0 - cos( DNu ) );
+        g = Ro4 * R4 * sin( DNu ) / sqrt( p );
+        gDot = 1.0 - ( Ro4 / p ) * ( 1.0 - cos( DNu ) );
+    }
 
-    // a = rp * m / (2.0 * xn * y * y);  -- XXX commented out in original
-    // Find eccentric anomalies
-    // Hyperbolic
-    if ( a < -SMALL )
+    else
     {
-        arg1 = sqrt( s / ( -2.0 * a ) );
-        arg2 = sqrt( ( s - chord ) / ( -2.0 * a ) );
-
-        // evaluate f and g functions
-
-        /*
-         * C++ note: asinh() acosh() and atanh() are not in the C90
-         * standard.
-         * doing #include <math.h> may or may not transparently
-         * include the appropriate header, ymmv.
-         *
-         * asinh() and friends will work, if...
-         *
-         * FreeBSD: in /usr/include/math.h, only if 
-         * #if __BSD_VISIBLE || __ISO_C_VISIBLE >= 1999 || __XSI_VISIBLE
-         *
-         * Linux RHEL: [TODO] it's not in /usr/include/math.h... yet it works?
-         *
-         * AIX 4.3: in /usr/include/math.h, only if
-         * #if _XOPEN_SOURCE_EXTENDED==1
-         *
-         * MacOS X: [TODO]
-         */
-        AlpH = 2.0 * asinh( arg1 );
-
-    } // end if
+        a = t * t / ( 16.0 * rp * rp * xn * y * y );
 
+        // a = rp * m / (2.0 * xn * y * y);  -- XXX commented out in original
+        // Find eccentric anomalies
+        if ( a < 0.0 )
+        {
+            // Hyperbolic
+
+            /*
+             * C++ note: asinh() acosh() and atanh() are not in the C90
+             * standard.
+             * doing #include <math.h> may or may not transparently
+             * include the appropriate header, ymmv.
+             *
+             * asinh() and friends will work, if...
+             *
+             * FreeBSD: in /usr/include/math.h, only if
+             * #if __BSD_VISIBLE || __ISO_C_VISIBLE >= 1999 || __XSI_VISIBLE
+             *
+             * Linux RHEL: [TODO] it's not in /usr/include/math.h... yet it works?
+             *
+             * AIX 4.3: in /usr/include/math.h, only if
+             * #if _XOPEN_SOURCE_EXTENDED==1
+             *
+             * MacOS X: [TODO]
+             */
+            AlpH = 2.0 * asinh( sqrt( s / ( -2.0 * a ) ) );
+            BetH = 2.0 * asinh( sqrt( ( s - chord ) / ( -2.0 * a ) ) );
+
+            if ( true == longway )
+                BetH = -BetH;
+
+            DH = AlpH - BetH;
+            f = 1.0 - ( a / Ro4 ) * ( 1.0 - cosh( DH ) );
+            gDot = 1.0 - ( a / R4 ) * ( 1.0 - cosh( DH ) );
+            g = t - sqrt( -a * a * a ) * ( sinh( DH ) - DH );
+        }
+
+        else
+        {
+            // Elliptic
+            AlpE = 2.0 * asin( sqrt( s / ( 2.0 * a ) ) );
+            BetE = 2.0 * asin( sqrt( ( s - chord ) / ( 2.0 * a ) ) );
+
+            // Time of flight on the minimum energy ellipse, to tell
+            // which side of it this transfer is on.
+            am = 0.5 * s;
+            be = 2.0 * asin( sqrt( ( s - chord ) / s ) );
+
+            if ( true == longway )
+            {
+                BetE = -BetE;
+                be = -be;
+            }
+
+            tm = sqrt( am * am * am ) * ( M_PI - ( be - sin( be ) ) );
+
+            if ( t > tm )
+                AlpE = 2.0 * M_PI - AlpE;
+
+            DE = AlpE - BetE;
+            f = 1.0 - ( a / Ro4 ) * ( 1.0 - cos( DE ) );
+            gDot = 1.0 - ( a / R4 ) * ( 1.0 - cos( DE ) );
+            g = t - sqrt( a * a * a ) * ( DE - sin( DE ) );
+        }
+    }
+
+    Vo = ( R - f * Ro ) / g;
+    V = ( gDot * R - Ro ) / g;
+
+    if ( ! ( norm( Vo ) < INF ) || ! ( norm( V ) < INF ) )
+    {
+        // Degenerate geometry, e.g. 180 degrees apart.
+        Vo.toInf();
+        V.toInf();
+        failure = true;
+    }
 } // end BLambert::battin
 
 /**
@@ -272,18 +371,36 @@ BLambert::battin ( void )
 double
 BLambert::bat_SEE( double v )
 {
-    // c: array (0..20) of Real;
-    double c[ 20 ];
-    double term, termold, del, delold, sum1, temp, eta, SQRTopv;
-    int i;
-
-    c[ 0 ] = 0.2;
+    // c: array (0..20) of Real; c(j) = (j+2)^2 / (4 (j+2)^2 - 1), j > 0
+    // Static function variables are initialized once and only one
+    // copy is created even if the function is called recursively.
+    static const double c[] =
+        {
+            0.2,
+            ( 9.0 / 35.0 ),
+            ( 16.0 / 63.0 ),
+            ( 25.0 / 99.0 ),
+            ( 36.0 / 143.0 ),
+            ( 49.0 / 195.0 ),
+            ( 64.0 / 255.0 ),
+            ( 81.0 / 323.0 ),
+            ( 100.0 / 399.0 ),
+            ( 121.0 / 483.0 ),
+            ( 144.0 / 575.0 ),
+            ( 169.0 / 675.0 ),
+            ( 196.0 / 783.0 ),
+            ( 225.0 / 899.0 ),
+            ( 256.0 / 1023.0 ),
+            ( 289.0 / 1155.0 ),
+            ( 324.0 / 1295.0 ),
+            ( 361.0 / 1443.0 ),
+            ( 400.0 / 1599.0 ),
+            ( 441.0 / 1763.0 ),
+            ( 484.0 / 1935.0 )
+        };
 
-    for ( int j = 1; j < 21; j++ )
-    {
-        temp = j + 2.0;
-        c[ j ] = ( temp * temp ) / ( ( 4 * temp * temp ) - 1 );
-    }
+    double term, termold, del, delold, sum1, eta, SQRTopv;
+    int i;
 
     SQRTopv = sqrt( 1.0 + v );
     eta = v / ( 1.0 + 2 * SQRTopv + SQRTopv * SQRTopv );
@@ -294,7 +411,7 @@ BLambert::bat_SEE( double v )
     sum1 = termold;
     i = 1;
 
-    while ( ( i <= 20 ) && ( fabs( termold ) > 0.000001 ) )
+    while ( ( i <= 20 ) && ( fabs( termold ) > SMALL * SMALL ) )
     {
         del = 1.0 / ( 1.0 + c[ i ] * eta * delold );
         term = termold * ( del - 1.0 );
@@ -320,7 +437,6 @@ BLambert::bat_K( double v )
 
     static const double d[] =
         {
-            0,
             ( 1.0 / 3.0 ),
             ( 4.0 / 27.0 ),
             ( 8.0 / 27.0 ),
@@ -348,12 +464,12 @@ BLambert::bat_K( double v )
     double del, delold, term, termold, sum1;
 
     // process fowards
-    sum1 = d[ 0 ]; // XXX check wtf i was thinking
+    sum1 = d[ 0 ];
     delold = 1.0;
     termold = d[ 0 ];
     i = 1;
 
-    while ( ( i <= 20 ) && ( fabs( termold > 0.000001 ) ) )
+    while ( ( i <= 20 ) && ( fabs( termold ) > SMALL * SMALL ) )
     {
         del = 1.0 / ( 1.0 - d[ i ] * v * delold );
         term = termold * ( del - 1.0 );
@@ -49,10 +49,10 @@ class BLambert
                    Vec3 r2in,
                    double tin );
 
-        virtual ~BLambert ( void );
+        ~BLambert ( void );
 
 
-        void battin( void );
+        void battin( const bool );  // true for the long way
         double bat_SEE( double );
         double bat_K( double );
 
@@ -65,6 +65,7 @@ class BLambert
         double gett ( void );
 
         bool isFailure( void );
+        int getIterations( void );
 
     private:
         double t;   //!< specified time of flight from Ro to R.
@@ -76,6 +77,7 @@ class BLambert
         Vec3 V;   //!< final velocity at the end of transfer arc.
 
         bool failure;   //!< is true if the solution fails to converge.
+        int iterations; //!< iterations used by the last solution.
 };
 
 #endif /* _BLAMBERT_H_ */
@@ -0,0 +1,351 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include "Anomaly.h"
+#include "Catalog.h"
+#include "Constellation.h"
+#include "Kepler.h"
+#include "Orbgnosis.h"
+#include "Traj.h"
+#include "TrajState.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Catalog constructor, for an empty catalog.
+ */
+Catalog::Catalog ( void ) :
+        epoch( 0.0 )
+{
+}
+
+/**
+ * Catalog constructor that reads the objects from a file.
+ * Each line holds one element set, in the same order and canonical units
+ * as Traj::set_elorb() (a, e, i, raan, w, f), separated by spaces or
+ * commas, so the output of Traj::print_El() can be read back.  Anything
+ * after a '#' is a comment.
+ * @param filename the element set file.
+ */
+Catalog::Catalog ( const char* filename ) :
+        epoch( 0.0 )
+{
+    ifstream elfile( filename );
+    string line;
+    double ain, ein, iin, raanin, win, fin;
+
+    if ( ! elfile.is_open() )
+    {
+        cerr << "ERROR: Catalog can't open " << filename << endl;
+        exit( 1 );
+    }
+
+    while ( getline( elfile, line ) )
+    {
+        line = line.substr( 0, line.find( '#' ) );
+
+        for ( size_t k = 0; k < line.size(); k++ )
+            if ( ',' == line[ k ] )
+                line[ k ] = ' ';
+
+        istringstream s( line );
+
+        if ( s >> ain >> ein >> iin >> raanin >> win >> fin )
+        {
+            Traj t( ain, ein, iin, raanin, win, fin );
+            add( t );
+        }
+    }
+}
+
+/**
+ * Catalog constructor that copies every target of a constellation.
+ * @param con the constellation.
+ */
+Catalog::Catalog ( Constellation& con ) :
+        epoch( 0.0 )
+{
+    for ( int k = 0; k < con.numTargets; k++ )
+        add( con.t10s[ k ] );
+}
+
+/**
+ * Catalog destructor.
+ */
+Catalog::~Catalog ( void )
+{
+}
+
+/**
+ * Append one object, at epoch zero.  If the catalog has been propagated,
+ * the new object's state is at epoch zero until the next propagate_to().
+ * @param t the object's trajectory at epoch zero.
+ */
+void
+Catalog::add ( Traj& t )
+{
+    Vec3 r = t.get_r();
+    Vec3 v = t.get_v();
+    bool closed = ( t.get_e() < 1.0 );
+
+    a.push_back( t.get_a() );
+    e.push_back( t.get_e() );
+    i.push_back( t.get_i() );
+    raan.push_back( t.get_raan() );
+    w.push_back( t.get_w() );
+    f.push_back( t.get_f() );
+    M.push_back( closed ? t.get_M() : 0.0 );
+
+    n.push_back( closed ? sqrt( 1.0 / ( t.get_a() * t.get_a() * t.get_a() ) ) : 0.0 );
+    M_dot.push_back( t.get_M_dot() );
+    raan_dot.push_back( t.get_raan_dot() );
+    w_dot.push_back( t.get_w_dot() );
+
+    perifocal( t.get_i(), t.get_raan(), t.get_w() );
+
+    rx.push_back( r.getX() );
+    ry.push_back( r.getY() );
+    rz.push_back( r.getZ() );
+    vx.push_back( v.getX() );
+    vy.push_back( v.getY() );
+    vz.push_back( v.getZ() );
+
+    if ( ! closed )
+    {
+        open.push_back( size() - 1 );
+        open_0.push_back( traj_state( t, 0.0 ) );
+    }
+}
+
+/**
+ * Append the perifocal unit vectors of an orbit.
+ * @param incl inclination.
+ * @param node right ascension of the ascending node.
+ * @param argp argument of periapsis.
+ */
+void
+Catalog::perifocal ( double incl, double node, double argp )
+{
+    double ci = cos( incl ), si = sin( incl );
+    double cn = cos( node ), sn = sin( node );
+    double cw = cos( argp ), sw = sin( argp );
+
+    Px.push_back( cn * cw - sn * sw * ci );
+    Py.push_back( sn * cw + cn * sw * ci );
+    Pz.push_back( sw * si );
+    Qx.push_back( -cn * sw - sn * cw * ci );
+    Qy.push_back( -sn * sw + cn * cw * ci );
+    Qz.push_back( cw * si );
+}
+
+/**
+ * Number of objects in the catalog.
+ */
+int
+Catalog::size ( void ) const
+{
+    return ( int ) a.size();
+}
+
+/**
+ * Propagate every object from epoch zero to epoch t with the run's
+ * propagator (see target_propagator).  Blocks of CATALOG_BLOCK objects are
+ * spread across threads.  Objects which can't be propagated get NaN states.
+ * @param t the new epoch (TU).
+ * @return the number of objects which couldn't be propagated.
+ */
+int
+Catalog::propagate_to ( double t )
+{
+    int nobj = size();
+    int nblock = ( nobj + CATALOG_BLOCK - 1 ) / CATALOG_BLOCK;
+    int nopen = ( int ) open.size();
+    int failures = 0;
+
+    #pragma omp parallel for schedule(static)
+    for ( int b = 0; b < nblock; b++ )
+    {
+        int lo = b * CATALOG_BLOCK;
+        int hi = ( lo + CATALOG_BLOCK < nobj ) ? lo + CATALOG_BLOCK : nobj;
+        propagate_block( lo, hi, t );
+    }
+
+    // Open orbits are rare; kepler_state() them one at a time.
+    #pragma omp parallel for schedule(dynamic) reduction(+:failures)
+    for ( int o = 0; o < nopen; o++ )
+    {
+        int k = open[ o ];
+        TrajState s;
+
+        try
+        {
+            s = ( fabs( t ) <= SMALL ) ? open_0[ o ] : kepler_state( open_0[ o ], t );
+        }
+        catch ( int ex )
+        {
+            failures++;
+            s.r = Vec3( NAN, NAN, NAN );
+            s.v = Vec3( NAN, NAN, NAN );
+        }
+
+        rx[ k ] = s.r.getX();
+        ry[ k ] = s.r.getY();
+        rz[ k ] = s.r.getZ();
+        vx[ k ] = s.v.getX();
+        vy[ k ] = s.v.getY();
+        vz[ k ] = s.v.getZ();
+    }
+
+    epoch = t;
+    return failures;
+}
+
+/**
+ * Propagate the closed orbits among objects lo to hi - 1 from their
+ * elements, with one batch solution of Kepler's equation.
+ * @param lo first object.
+ * @param hi one past the last object.
+ * @param t the new epoch (TU).
+ */
+void
+Catalog::propagate_block ( int lo, int hi, double t )
+{
+    bool j2 = ( PROPAGATE_SECULAR_J2 == target_propagator );
+    double Mt[ CATALOG_BLOCK ];
+    double ft[ CATALOG_BLOCK ];
+    int nb = hi - lo;
+
+    for ( int k = 0; k < nb; k++ )
+        Mt[ k ] = fmod( M[ lo + k ] + ( j2 ? M_dot[ lo + k ] : n[ lo + k ] ) * t,
+                        2.0 * M_PI );
+
+    mean_to_true( nb, Mt, &e[ lo ], ft );
+
+    for ( int k = 0; k < nb; k++ )
+    {
+        int o = lo + k;
+        double P[ 3 ] = { Px[ o ], Py[ o ], Pz[ o ] };
+        double Q[ 3 ] = { Qx[ o ], Qy[ o ], Qz[ o ] };
+
+        if ( e[ o ] >= 1.0 )
+            continue;
+
+        if ( j2 )
+        {
+            // The node and periapsis have moved; rebuild the frame.
+            double ci = cos( i[ o ] ), si = sin( i[ o ] );
+            double node = raan[ o ] + raan_dot[ o ] * t;
+            double argp = w[ o ] + w_dot[ o ] * t;
+            double cn = cos( node ), sn = sin( node );
+            double cw = cos( argp ), sw = sin( argp );
+
+            P[ 0 ] = cn * cw - sn * sw * ci;
+            P[ 1 ] = sn * cw + cn * sw * ci;
+            P[ 2 ] = sw * si;
+            Q[ 0 ] = -cn * sw - sn * cw * ci;
+            Q[ 1 ] = -sn * sw + cn * cw * ci;
+            Q[ 2 ] = cw * si;
+        }
+
+        // As in elements_to_rv(), but in the perifocal frame.
+        double p = a[ o ] * ( 1.0 - e[ o ] * e[ o ] );
+        double cos_f = cos( ft[ k ] );
+        double sin_f = sin( ft[ k ] );
+        double rr = p / ( 1.0 + e[ o ] * cos_f );
+        double vp = 1.0 / sqrt( ( fabs( p ) < SMALL ) ? SMALL : p );
+        double rp = rr * cos_f, rq = rr * sin_f;
+        double vq = vp * ( e[ o ] + cos_f );
+
+        vp *= -sin_f;
+        rx[ o ] = rp * P[ 0 ] + rq * Q[ 0 ];
+        ry[ o ] = rp * P[ 1 ] + rq * Q[ 1 ];
+        rz[ o ] = rp * P[ 2 ] + rq * Q[ 2 ];
+        vx[ o ] = vp * P[ 0 ] + vq * Q[ 0 ];
+        vy[ o ] = vp * P[ 1 ] + vq * Q[ 1 ];
+        vz[ o ] = vp * P[ 2 ] + vq * Q[ 2 ];
+    }
+}
+
+/**
+ * Epoch of the state vectors (TU).
+ */
+double
+Catalog::get_epoch ( void ) const
+{
+    return epoch;
+}
+
+/**
+ * State of one object at the current epoch.
+ * @param k the object.
+ */
+TrajState
+Catalog::get_state ( int k ) const
+{
+    TrajState s;
+
+    s.r = Vec3( rx[ k ], ry[ k ], rz[ k ] );
+    s.v = Vec3( vx[ k ], vy[ k ], vz[ k ] );
+    s.t = epoch;
+    return s;
+}
+
+/**
+ * Trajectory of one object at epoch zero.
+ * @param k the object.
+ */
+Traj
+Catalog::get_traj ( int k ) const
+{
+    return Traj( a[ k ], e[ k ], i[ k ], raan[ k ], w[ k ], f[ k ] );
+}
+
+/**
+ * An ordinary Constellation of a few objects, at epoch zero, for the tour
+ * problems and anything else which wants whole Trajs.
+ * @param members the objects, in constellation order.
+ */
+Constellation
+Catalog::constellation ( const vector<int>& members ) const
+{
+    Constellation con( ( int ) members.size() );
+
+    for ( size_t k = 0; k < members.size(); k++ )
+        con.t10s[ k ] = get_traj( members[ k ] );
+
+    return con;
+}
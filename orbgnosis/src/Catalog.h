@@ -0,0 +1,120 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * A catalog of many orbiting objects, stored as structures of arrays.
+ */
+
+#ifndef _CATALOG_H_
+#define _CATALOG_H_
+#include "Traj.h"
+#include "TrajState.h"
+#include <vector>
+
+using namespace std;
+
+#define CATALOG_BLOCK 256  //!< objects propagated together by one thread.
+
+class Constellation;
+
+/**
+ * Constellation keeps a whole Traj per satellite, which is fine for the
+ * handful a tour visits and far too much for a catalog of thousands of
+ * objects to screen.  Catalog keeps only what propagation needs, one
+ * array per quantity: the elements and secular rates at epoch zero, and
+ * the state vectors at the current epoch.  propagate_to() moves the whole
+ * catalog to a new epoch in parallel, a block of objects at a time, with
+ * one batch solution of Kepler's equation per block.  Two-body orbits
+ * keep their perifocal frame, so each object then costs one sine and one
+ * cosine.
+ *
+ * Closed orbits are propagated from their elements, with or without the
+ * secular J2 rates as target_propagator says.  Open orbits have no mean
+ * anomaly to advance, so they go through kepler_state() from their epoch
+ * zero state.
+ *
+ * Construction is quiet.  For the tour problems, constellation() copies
+ * a few objects out into an ordinary Constellation.
+ */
+class Catalog
+{
+
+    public:
+        Catalog ( void );
+        Catalog ( const char* );             // reads elsets from a file
+        Catalog ( Constellation& );          // copies a constellation
+
+        virtual ~Catalog ( void );
+
+        void add ( Traj& );                  // appends one object
+        int size ( void ) const;
+
+        int propagate_to ( double );         // returns failures
+        double get_epoch ( void ) const;
+        TrajState get_state ( int ) const;   // at the current epoch
+        Traj get_traj ( int ) const;         // at epoch zero
+
+        Constellation constellation ( const vector<int>& ) const;
+
+        // Elements at epoch zero (ER, radians).
+        vector<double> a;
+        vector<double> e;
+        vector<double> i;
+        vector<double> raan;
+        vector<double> w;
+        vector<double> f;
+        vector<double> M;
+
+        // Secular rates (radians/TU).  n is the two-body mean motion,
+        // M_dot includes J2's drift.  All zero for open orbits.
+        vector<double> n;
+        vector<double> M_dot;
+        vector<double> raan_dot;
+        vector<double> w_dot;
+
+        // Perifocal unit vectors at epoch zero: P toward periapsis, Q
+        // 90 degrees ahead of it in the orbit plane.
+        vector<double> Px, Py, Pz;
+        vector<double> Qx, Qy, Qz;
+
+        // State vectors at the current epoch (ER, ER/TU).
+        vector<double> rx, ry, rz;
+        vector<double> vx, vy, vz;
+
+    private:
+        void perifocal ( double, double, double );
+        void propagate_block ( int, int, double );
+
+        double epoch;               //!< epoch of the state vectors (TU).
+        vector<int> open;           //!< indices of the open orbits.
+        vector<TrajState> open_0;   //!< their states at epoch zero.
+};
+
+#endif /* _CATALOG_H_ */
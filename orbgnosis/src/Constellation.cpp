@@ -28,6 +28,8 @@
 * Contributor(s):  Ted Stodgell <trs137@psu.edu>
 */
 
+#include "Anomaly.h"
+#include "Catalog.h"
 #include "Constellation.h"
 #include "Orbgnosis.h"
 #include "Traj.h"
@@ -46,9 +48,35 @@ Constellation::Constellation (int n) :
 {
     // Set size for container of trajectories.
     t10s.resize(numTargets);
-    cout << "Constellation constructor called. ";
-    cout << "This constellation has " << n << " satellites.";
-    cout << endl;
+}
+
+/**
+ * Constellation constructor that reads the satellites from a file.
+ * Each line holds one element set, in the same order and canonical units
+ * as Traj::set_elorb() (a, e, i, raan, w, f), separated by spaces or
+ * commas, so the output of Traj::print_El() can be read back.  Anything
+ * after a '#' is a comment.
+ * @param filename the element set file.
+ */
+Constellation::Constellation (const char* filename) :
+        numTargets(read_elsets(filename, t10s))
+{
+}
+
+/**
+ * Read element sets from a file into a container of trajectories.
+ * The file format belongs to Catalog, which does the reading.
+ * Returns the number of trajectories read.
+ */
+int
+Constellation::read_elsets (const char* filename, vector<Traj>& t)
+{
+    Catalog cat(filename);
+
+    for (int k = 0; k < cat.size(); k++)
+        t.push_back(cat.get_traj(k));
+
+    return (int)t.size();
 }
 
 /**
@@ -68,7 +96,6 @@ Constellation::Constellation (const Constellation& copy) :
  */
 Constellation::~Constellation (void)
 {
-    cout << "Constellation destructor called." << endl;
 }
 
 /**
@@ -116,12 +143,19 @@ Constellation::set_all(Traj t)
 void
 Constellation::distribute(Traj t)
 {
-    double M = t.get_M();
+    double M0 = t.get_M();
+    vector<double> M(numTargets), e(numTargets, t.get_e()), f(numTargets);
+
+    for (int i = 0; i < numTargets; i++)
+        M[i] = fmod(M0 + i*2.0*M_PI / numTargets, 2.0*M_PI);
+
+    // One batch solution of Kepler's equation for the whole plane.
+    mean_to_true(numTargets, &M[0], &e[0], &f[0]);
 
     for (int i = 0; i < numTargets; i++)
     {
         t10s[i] = t;
-        t10s[i].set_M( fmod(M + i*2.0*M_PI / numTargets, 2.0*M_PI));
+        t10s[i].set_f(f[i] < 0.0 ? f[i] + 2.0*M_PI : f[i]);
     }
 }
 
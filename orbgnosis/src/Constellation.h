@@ -36,7 +36,9 @@
 using namespace std;
 
 /**
- * A group of target satellites to be visited.
+ * A group of target satellites to be visited.  For catalogs of more than
+ * a few satellites, see Catalog, which can hand a few of them over as a
+ * Constellation.
  */
 
 class Constellation
@@ -44,6 +46,7 @@ class Constellation
 
     public:
         Constellation (int);                    // constructor
+        Constellation (const char*);            // reads elsets from a file
         Constellation (const Constellation&);   // copy ctor
 
         virtual ~Constellation (void);          // destructor
@@ -66,6 +69,9 @@ class Constellation
 
         vector<Traj> t10s;          // t10s is short for "trajectories"
         const int numTargets;       // # of satellites in constellation
+
+    private:
+        static int read_elsets (const char*, vector<Traj>&);
 };
 
 #endif /* _CONSTELLATION_H_ */
@@ -0,0 +1,233 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include "EvalMemo.h"
+
+using namespace std;
+
+EvalMemo* eval_memo = NULL;
+
+/**
+ * EvalMemo constructor, an empty memo for chromosomes of the given shape.
+ */
+EvalMemo::EvalMemo ( int nr, int nb, const int* bits, int np, int no, int nc,
+                     double q ) :
+        hits( 0 ),
+        nreal( nr ),
+        nbin( nb ),
+        nperm( np ),
+        nobj( no ),
+        ncon( nc ),
+        quantum( q )
+{
+    int total = 0;
+
+    for ( int i = 0; i < nbin; i++ )
+    {
+        nbits.push_back( bits[ i ] );
+        total += bits[ i ];
+    }
+
+    width = nreal + ( total + 63 ) / 64 + nperm;
+    key.assign( width, 0 );
+    slots.assign( 1024, -1 );
+}
+
+/**
+ * EvalMemo destructor.
+ */
+EvalMemo::~EvalMemo ( void )
+{
+}
+
+/**
+ * Build the key of a chromosome in key[].
+ */
+void
+EvalMemo::make_key ( const double* xreal, int** gene, const int* perm )
+{
+    int w = 0;
+    int b = 0;
+
+    for ( int i = 0; i < nreal; i++, w++ )
+    {
+        if ( quantum > 0.0 )
+            key[ w ] = (uint64_t)(int64_t)floor( xreal[ i ] / quantum + 0.5 );
+        else
+            memcpy( &key[ w ], &xreal[ i ], sizeof( double ) );
+    }
+
+    for ( int i = nreal; i < width - nperm; i++ )
+        key[ i ] = 0;
+
+    for ( int i = 0; i < nbin; i++ )
+    {
+        for ( int j = 0; j < nbits[ i ]; j++, b++ )
+        {
+            if ( gene[ i ][ j ] )
+                key[ w + b / 64 ] |= (uint64_t)1 << ( b % 64 );
+        }
+    }
+
+    w = width - nperm;
+
+    for ( int i = 0; i < nperm; i++, w++ )
+        key[ w ] = (uint64_t)perm[ i ];
+}
+
+/**
+ * FNV-1a over the words of a key.
+ */
+uint64_t
+EvalMemo::hash ( const uint64_t* k )
+{
+    uint64_t h = 14695981039346656037ULL;
+
+    for ( int i = 0; i < width; i++ )
+    {
+        h ^= k[ i ];
+        h *= 1099511628211ULL;
+    }
+
+    return h ^ ( h >> 29 );
+}
+
+/**
+ * Find the slot of key[], or the empty slot where it belongs.
+ */
+int
+EvalMemo::lookup ( uint64_t h )
+{
+    size_t mask = slots.size() - 1;
+    size_t s = (size_t)h & mask;
+
+    while ( slots[ s ] >= 0 )
+    {
+        if ( 0 == memcmp( &keys[ (size_t)slots[ s ] * width ], &key[ 0 ],
+                          width * sizeof( uint64_t ) ) )
+            break;
+
+        s = ( s + 1 ) & mask;
+    }
+
+    return (int)s;
+}
+
+/**
+ * Double the table and put every entry back.
+ */
+void
+EvalMemo::grow ( void )
+{
+    size_t mask = slots.size() * 2 - 1;
+
+    slots.assign( slots.size() * 2, -1 );
+
+    for ( long e = 0; e < size(); e++ )
+    {
+        size_t s = (size_t)hash( &keys[ e * width ] ) & mask;
+
+        while ( slots[ s ] >= 0 )
+            s = ( s + 1 ) & mask;
+
+        slots[ s ] = (int)e;
+    }
+}
+
+/**
+ * Look up a chromosome.
+ * @param xreal its real variables.
+ * @param gene its binary genes.
+ * @param perm its permutation.
+ * @param obj gets its objectives, if it is known.
+ * @param constr gets its constraints, if it is known.
+ * @return true if it was known.
+ */
+bool
+EvalMemo::find ( const double* xreal, int** gene, const int* perm,
+                 double* obj, double* constr )
+{
+    make_key( xreal, gene, perm );
+    int s = lookup( hash( &key[ 0 ] ) );
+
+    if ( slots[ s ] < 0 )
+        return false;
+
+    const double* v = &values[ (size_t)slots[ s ] * ( nobj + ncon ) ];
+
+    for ( int i = 0; i < nobj; i++ )
+        obj[ i ] = v[ i ];
+
+    for ( int i = 0; i < ncon; i++ )
+        constr[ i ] = v[ nobj + i ];
+
+    hits++;
+    return true;
+}
+
+/**
+ * Remember the result for a chromosome.  If it is already known, the
+ * first result is kept.
+ * @param xreal its real variables.
+ * @param gene its binary genes.
+ * @param perm its permutation.
+ * @param obj its objectives.
+ * @param constr its constraints.
+ */
+void
+EvalMemo::insert ( const double* xreal, int** gene, const int* perm,
+                   const double* obj, const double* constr )
+{
+    make_key( xreal, gene, perm );
+    int s = lookup( hash( &key[ 0 ] ) );
+
+    if ( slots[ s ] >= 0 )
+        return;
+
+    slots[ s ] = (int)size();
+    keys.insert( keys.end(), key.begin(), key.end() );
+    values.insert( values.end(), obj, obj + nobj );
+    values.insert( values.end(), constr, constr + ncon );
+
+    if ( 2 * size() > (long)slots.size() )
+        grow();
+}
+
+/**
+ * How many chromosomes are remembered.
+ */
+long
+EvalMemo::size ( void )
+{
+    return (long)( values.size() / ( nobj + ncon ) );
+}
@@ -0,0 +1,94 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#ifndef _EVALMEMO_H_
+#define _EVALMEMO_H_
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Every evaluation of the run, so a chromosome seen before is copied
+ * instead of evaluated again.  The key is the chromosome: real variables,
+ * binary genes and the permutation.  The value is its objectives and
+ * constraints.  A hash table with linear probing, doubled as it fills.
+ *
+ * Real variables are compared by their bits, or rounded to a multiple of
+ * a quantum if one is given.  With a quantum, chromosomes which round the
+ * same share the result of whichever was evaluated first.
+ */
+class EvalMemo
+{
+
+    public:
+        EvalMemo ( int,         // real variables
+                   int,         // binary variables
+                   const int*,  // bits of each binary variable
+                   int,         // permutation length
+                   int,         // objectives
+                   int,         // constraints
+                   double );    // quantum, 0 to compare exactly
+        ~EvalMemo ( void );
+
+        // Copy out the result for a chromosome, false if it isn't known.
+        bool find ( const double*, int**, const int*, double*, double* );
+
+        // Remember the result for a chromosome.
+        void insert ( const double*, int**, const int*, const double*, const double* );
+
+        long size ( void );     // chromosomes remembered.
+
+        long hits;      //!< successful find()s.
+
+    private:
+        void make_key ( const double*, int**, const int* );
+        uint64_t hash ( const uint64_t* );
+        int lookup ( uint64_t );
+        void grow ( void );
+
+        int nreal;                  //!< real variables.
+        int nbin;                   //!< binary variables.
+        vector<int> nbits;          //!< bits of each binary variable.
+        int nperm;                  //!< permutation length.
+        int nobj;                   //!< objectives.
+        int ncon;                   //!< constraints.
+        double quantum;             //!< rounding of real variables, 0 for none.
+        int width;                  //!< words per key.
+
+        vector<uint64_t> key;       //!< scratch key for the current chromosome.
+        vector<uint64_t> keys;      //!< width words per entry.
+        vector<double> values;      //!< nobj + ncon values per entry.
+        vector<int> slots;          //!< entry number, -1 for empty.
+};
+
+extern EvalMemo* eval_memo;  //!< the run's memo, NULL to evaluate everything.
+
+#endif /* _EVALMEMO_H_ */
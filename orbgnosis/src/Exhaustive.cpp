@@ -0,0 +1,360 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include "Exhaustive.h"
+#include "Graph.h"
+#include <algorithm>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+#define EXHAUSTIVE_TASKS 16     //!< tasks per thread, at least.
+#define EXHAUSTIVE_RESYNC 4095  //!< recost from scratch every 4096 tours.
+
+/**
+ * Exhaustive constructor.
+ * @param graphin the graph, whose costs must be up to date.
+ * @param nobjin number of objectives, 1 or 2.
+ * @param which the edge cost of each objective.
+ */
+Exhaustive::Exhaustive ( const Graph& graphin, int nobjin,
+                         const graph_cost* which ) :
+        tours( 0 ),
+        graph( graphin ),
+        n( graphin.numTargets ),
+        nobj( nobjin )
+{
+    if ( ( nobj < 1 ) || ( nobj > EXHAUSTIVE_MAXOBJ )
+            || ( n < 1 ) || ( n > EXHAUSTIVE_MAXNODES ) )
+    {
+        cerr << "ERROR: Exhaustive takes 1 to " << EXHAUSTIVE_MAXOBJ
+        << " objectives and 1 to " << EXHAUSTIVE_MAXNODES << " nodes." << endl;
+        exit( 1 );
+    }
+
+    for ( int k = 0; k < nobj; k++ )
+        costs[ k ] = graph.get_costs( which[ k ] );
+}
+
+/**
+ * Exhaustive destructor.
+ */
+Exhaustive::~Exhaustive ( void )
+{
+}
+
+/**
+ * Evaluate every tour, and leave the nondominated ones in front.
+ */
+void
+Exhaustive::search ( void )
+{
+    int threads = 1;
+    int depth = 0;
+    long long ntasks = 1;
+    vector<int> prefixes;
+
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+
+    // Fix the first few nodes after 0, enough to keep every thread busy.
+    while ( ( depth < n - 1 ) && ( ntasks < EXHAUSTIVE_TASKS * threads ) )
+    {
+        ntasks *= n - 1 - depth;
+        depth++;
+    }
+
+    // Every ordered choice of depth nodes from 1..n-1, in order.
+    vector<int> p( depth );
+    vector<bool> used( n, false );
+    int level = 0;
+    int next = 1;
+
+    while ( level >= 0 )
+    {
+        if ( level == depth )
+        {
+            prefixes.insert( prefixes.end(), p.begin(), p.end() );
+
+            if ( 0 == depth )
+                break;
+
+            level--;
+            used[ p[ level ] ] = false;
+            next = p[ level ] + 1;
+            continue;
+        }
+
+        while ( ( next < n ) && used[ next ] )
+            next++;
+
+        if ( next < n )
+        {
+            p[ level ] = next;
+            used[ next ] = true;
+            level++;
+            next = 1;
+        }
+        else if ( --level >= 0 )
+        {
+            used[ p[ level ] ] = false;
+            next = p[ level ] + 1;
+        }
+    }
+
+    front.clear();
+    tours = 0;
+
+    #pragma omp parallel
+    {
+        vector<ExhaustiveTour> mine;
+        long long count = 0;
+
+        #pragma omp for schedule(dynamic)
+        for ( long long t = 0; t < ntasks; t++ )
+            walk( depth ? &prefixes[ t * depth ] : NULL, depth, mine, count );
+
+        #pragma omp critical
+        {
+            for ( size_t k = 0; k < mine.size(); k++ )
+                offer( front, mine[ k ].obj, &mine[ k ].order[ 0 ] );
+
+            tours += count;
+        }
+    }
+}
+
+/**
+ * Evaluate every tour which starts 0, prefix, and offer the good ones to
+ * a front.
+ * @param prefix the nodes visited after 0.
+ * @param depth how many there are.
+ * @param archive the front to offer tours to.
+ * @param count gets the number of tours evaluated added to it.
+ */
+void
+Exhaustive::walk ( const int* prefix, int depth, vector<ExhaustiveTour>& archive,
+                   long long& count ) const
+{
+    int path[ EXHAUSTIVE_MAXNODES ];
+    int c[ EXHAUSTIVE_MAXNODES + 1 ], o[ EXHAUSTIVE_MAXNODES + 1 ];
+    bool used[ EXHAUSTIVE_MAXNODES ] = { false };
+    double total[ EXHAUSTIVE_MAXOBJ ] = { 0.0 };
+    int base = depth + 1;       // path index of the first permuted node
+    int m = n - base;           // how many nodes are permuted
+
+    path[ 0 ] = 0;
+
+    for ( int k = 0; k < depth; k++ )
+    {
+        path[ k + 1 ] = prefix[ k ];
+        used[ prefix[ k ] ] = true;
+    }
+
+    for ( int v = 1, k = base; v < n; v++ )
+        if ( ! used[ v ] )
+            path[ k++ ] = v;
+
+    cost( path, total );
+
+    if ( may_enter( archive, total ) )
+        offer( archive, total, path );
+
+    count++;
+
+    // Algorithm P, with a[ j ] = path[ base + j - 1 ].
+    for ( int j = 1; j <= m; j++ )
+    {
+        c[ j ] = 0;
+        o[ j ] = 1;
+    }
+
+    for ( ;; )
+    {
+        int j = m, s = 0, q;
+
+        for ( ;; )
+        {
+            if ( j < 1 )
+                return;
+
+            q = c[ j ] + o[ j ];
+
+            if ( q < 0 )
+            {
+                o[ j ] = -o[ j ];
+                j--;
+            }
+            else if ( q == j )
+            {
+                if ( 1 == j )
+                    return;
+
+                s++;
+                o[ j ] = -o[ j ];
+                j--;
+            }
+            else
+                break;
+        }
+
+        // Swap path[ l ] and path[ l + 1 ], and patch the three edges
+        // around them.
+        int l = base - 1 + min( j - c[ j ] + s, j - q + s );
+        bool last = ( l + 2 >= n );
+
+        for ( int k = 0; k < nobj; k++ )
+        {
+            const double* e = costs[ k ];
+
+            total[ k ] -= e[ path[ l - 1 ] * n + path[ l ] ]
+                          + e[ path[ l ] * n + path[ l + 1 ] ]
+                          + ( last ? 0.0 : e[ path[ l + 1 ] * n + path[ l + 2 ] ] );
+        }
+
+        swap( path[ l ], path[ l + 1 ] );
+        c[ j ] = q;
+
+        for ( int k = 0; k < nobj; k++ )
+        {
+            const double* e = costs[ k ];
+
+            total[ k ] += e[ path[ l - 1 ] * n + path[ l ] ]
+                          + e[ path[ l ] * n + path[ l + 1 ] ]
+                          + ( last ? 0.0 : e[ path[ l + 1 ] * n + path[ l + 2 ] ] );
+        }
+
+        // Don't let the running totals wander far from the truth.
+        if ( 0 == ( ++count & EXHAUSTIVE_RESYNC ) )
+            cost( path, total );
+
+        if ( may_enter( archive, total ) )
+        {
+            double exact[ EXHAUSTIVE_MAXOBJ ] = { 0.0 };
+
+            cost( path, exact );
+            offer( archive, exact, path );
+        }
+    }
+}
+
+/**
+ * Total each cost of a tour, from scratch.
+ */
+void
+Exhaustive::cost ( const int* path, double* total ) const
+{
+    for ( int k = 0; k < nobj; k++ )
+    {
+        total[ k ] = 0.0;
+
+        for ( int c = 0; c < n - 1; c++ )
+            total[ k ] += costs[ k ][ path[ c ] * n + path[ c + 1 ] ];
+    }
+}
+
+/**
+ * Could a tour with these (running) totals get on the front?  A little
+ * slack allows for the running totals' roundoff.
+ */
+bool
+Exhaustive::may_enter ( const vector<ExhaustiveTour>& archive,
+                        const double* total ) const
+{
+    double x = total[ 0 ] * ( 1.0 - 1.0e-12 );
+    double y = ( nobj > 1 ) ? total[ 1 ] * ( 1.0 - 1.0e-12 ) : 0.0;
+
+    // The front point with the largest obj[0] <= x has the smallest obj[1].
+    int lo = 0, hi = ( int ) archive.size();
+
+    while ( lo < hi )
+    {
+        int mid = ( lo + hi ) / 2;
+
+        if ( archive[ mid ].obj[ 0 ] <= x )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return ( 0 == lo ) || ( archive[ lo - 1 ].obj[ 1 ] > y );
+}
+
+/**
+ * Offer a tour to a front, kept sorted by increasing obj[0] and so
+ * decreasing obj[1].  It goes on unless something on the front dominates
+ * it, and knocks off whatever it dominates.  A tie with a tour already on
+ * the front goes to the lexicographically smaller order.
+ */
+void
+Exhaustive::offer ( vector<ExhaustiveTour>& archive, const double* total,
+                    const int* path ) const
+{
+    ExhaustiveTour t;
+    double x = total[ 0 ];
+    double y = ( nobj > 1 ) ? total[ 1 ] : 0.0;
+    size_t pos = 0;
+
+    t.obj[ 0 ] = x;
+    t.obj[ 1 ] = y;
+    t.order.assign( path, path + n );
+
+    while ( ( pos < archive.size() ) && ( archive[ pos ].obj[ 0 ] <= x ) )
+        pos++;
+
+    if ( ( pos > 0 ) && ( archive[ pos - 1 ].obj[ 1 ] <= y ) )
+    {
+        ExhaustiveTour& f = archive[ pos - 1 ];
+
+        if ( ( f.obj[ 0 ] == x ) && ( f.obj[ 1 ] == y ) && ( t.order < f.order ) )
+            f.order = t.order;
+
+        return;
+    }
+
+    // Knock off what it dominates: from the first tour with obj[0] >= x,
+    // everything with obj[1] >= y.
+    size_t start = pos, end = pos;
+
+    while ( ( start > 0 ) && ( archive[ start - 1 ].obj[ 0 ] == x ) )
+        start--;
+
+    while ( ( end < archive.size() ) && ( archive[ end ].obj[ 1 ] >= y ) )
+        end++;
+
+    archive.erase( archive.begin() + start, archive.begin() + end );
+    archive.insert( archive.begin() + start, t );
+}
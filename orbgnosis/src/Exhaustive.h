@@ -0,0 +1,97 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Exhaustive search of every tour of a Graph, for ground truth.
+ */
+
+#ifndef _EXHAUSTIVE_H_
+#define _EXHAUSTIVE_H_
+#include "Graph.h"
+#include <vector>
+
+using namespace std;
+
+#define EXHAUSTIVE_MAXOBJ 2     //!< objectives, wsp1 has one and wsp2 two.
+#define EXHAUSTIVE_MAXNODES 16  //!< nodes, far more than anyone can wait for.
+
+/**
+ * One tour and what it costs.
+ */
+struct ExhaustiveTour
+{
+    double obj[ EXHAUSTIVE_MAXOBJ ];    //!< total of each cost.
+    vector<int> order;                  //!< nodes in visiting order, from 0.
+};
+
+/**
+ * Evaluates every tour of a Graph which starts at node 0 and visits each
+ * other node once, as wsp1 and wsp2 do, and keeps the nondominated ones.
+ *
+ * Tours are generated in Steinhaus-Johnson-Trotter order (Knuth's
+ * Algorithm P, "plain changes"), so each differs from the last by swapping
+ * two neighbors.  Only the three edges around the swap change, so each
+ * tour costs a few lookups in the graph's edge cost matrices instead of a
+ * sum over the whole path.  The running totals are only used to screen
+ * tours; one that might get on the front is costed from scratch.
+ *
+ * The tours are split by their first few nodes into many more tasks than
+ * there are threads, and each thread keeps its own front until the end.
+ * Ties go to the lexicographically smallest order, so the answer doesn't
+ * depend on the number of threads.
+ */
+class Exhaustive
+{
+
+    public:
+        Exhaustive ( const Graph&,          // the graph
+                     int,                   // number of objectives
+                     const graph_cost* );   // the cost of each objective
+
+        virtual ~Exhaustive ( void );
+
+        void search ( void );
+
+        vector<ExhaustiveTour> front;   //!< nondominated tours, by obj[0].
+        long long tours;                //!< tours evaluated.
+
+    private:
+        void walk ( const int*, int, vector<ExhaustiveTour>&, long long& ) const;
+        void cost ( const int*, double* ) const;
+        void offer ( vector<ExhaustiveTour>&, const double*, const int* ) const;
+        bool may_enter ( const vector<ExhaustiveTour>&, const double* ) const;
+
+        const Graph& graph;         //!< the graph.
+        int n;                      //!< its number of nodes.
+        int nobj;                   //!< number of objectives.
+        const double* costs[ EXHAUSTIVE_MAXOBJ ];   //!< each one's matrix.
+};
+
+#endif /* _EXHAUSTIVE_H_ */
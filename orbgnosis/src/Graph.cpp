@@ -47,6 +47,7 @@ Graph::Graph (int n) :
 {
     // Set size for container of trajectories.
     node.resize(numTargets);
+    find_costs();
     //cout << "Graph constructor called. ";
     //cout << "This graph has " << numTargets << " nodes." << endl;
 }
@@ -62,6 +63,9 @@ Graph::Graph (const Graph& copy) :
 
     for (int i = 0; i < numTargets; i++)
         node[i] = copy.node[i];
+
+    for (int k = 0; k < GRAPH_COSTS; k++)
+        cost[k] = copy.cost[k];
 }
 
 /**
@@ -100,6 +104,8 @@ Graph::set_all(Vec3 t)
     {
         node[i] = t;
     }
+
+    find_costs();
 }
 
 /**
@@ -124,4 +130,27 @@ Graph::noise(double n)
 
         node[j].set3(x, y, z);
     }
+
+    find_costs();
+}
+
+/**
+ * Work out the cost of every edge, for every kind of cost.  The tour
+ * evaluators only look the costs up.
+ */
+void
+Graph::find_costs(void)
+{
+    for (int k = 0; k < GRAPH_COSTS; k++)
+        cost[k].resize(numTargets * numTargets);
+
+    for (int a = 0; a < numTargets; a++)
+        for (int b = 0; b < numTargets; b++)
+        {
+            Vec3 edge = node[a] - node[b];
+
+            cost[COST_LENGTH][a * numTargets + b] = norm(edge);
+            cost[COST_X][a * numTargets + b] = fabs(edge.getX());
+            cost[COST_Y][a * numTargets + b] = fabs(edge.getY());
+        }
 }
@@ -35,8 +35,21 @@
 
 using namespace std;
 
+/**
+ * The edge costs Graph keeps a matrix of.
+ */
+enum graph_cost
+{
+    COST_LENGTH,    //!< straight line distance, the wsp1 objective.
+    COST_X,         //!< |dx|, the first wsp2 objective.
+    COST_Y,         //!< |dy|, the second wsp2 objective.
+    GRAPH_COSTS     //!< how many there are.
+};
+
 /**
  * A group of graph nodes to be visited.
+ * Every edge cost is worked out once, into a matrix, when the nodes are
+ * set.  Code which changes node[] directly must call find_costs() after.
  */
 
 class Graph
@@ -55,8 +68,29 @@ class Graph
         void set_all(Vec3);    // Sets every traj exactly the same.
         void noise(double);    // Perturbs each target slightly
 
+        void find_costs (void);  // Fills the edge cost matrices.
+
+        /**
+         * Cost of the edge from node a to node b.
+         */
+        inline double get_cost (graph_cost k, int a, int b) const
+        {
+            return cost[k][a * numTargets + b];
+        }
+
+        /**
+         * The whole matrix of one cost, row a holding the edges from a.
+         */
+        inline const double* get_costs (graph_cost k) const
+        {
+            return &cost[k][0];
+        }
+
         vector<Vec3> node;
         const int numTargets;       // # of satellites in constellation
+
+    private:
+        vector<double> cost[GRAPH_COSTS];   //!< numTargets^2 each.
 };
 
 #endif /* _GRAPH_H_ */
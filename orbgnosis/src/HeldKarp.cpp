@@ -0,0 +1,358 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include "Exhaustive.h"
+#include "Graph.h"
+#include "HeldKarp.h"
+#include "Orbgnosis.h"
+#include <algorithm>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Labels sort by x, then y.
+ */
+static inline bool
+label_less ( const HeldKarpLabel& a, const HeldKarpLabel& b )
+{
+    return ( a.x < b.x ) || ( ( a.x == b.x ) && ( a.y < b.y ) );
+}
+
+/**
+ * Sort labels and keep the nondominated ones, in place.
+ */
+static void
+pareto_filter ( vector<HeldKarpLabel>& l )
+{
+    size_t kept = 0;
+
+    sort( l.begin(), l.end(), label_less );
+
+    for ( size_t k = 0; k < l.size(); k++ )
+        if ( ( 0 == kept ) || ( l[ k ].y < l[ kept - 1 ].y ) )
+            l[ kept++ ] = l[ k ];
+
+    l.resize( kept );
+}
+
+/**
+ * HeldKarp constructor.
+ * @param graphin the graph, whose costs must be up to date.
+ * @param nobjin number of objectives, 1 or 2.
+ * @param which the edge cost of each objective.
+ */
+HeldKarp::HeldKarp ( const Graph& graphin, int nobjin, const graph_cost* which ) :
+        states( 0 ),
+        labels( 0 ),
+        graph( graphin ),
+        n( graphin.numTargets ),
+        m( graphin.numTargets - 1 ),
+        nobj( nobjin )
+{
+    if ( ( nobj < 1 ) || ( nobj > EXHAUSTIVE_MAXOBJ )
+            || ( n < 2 ) || ( n > HELDKARP_MAXNODES ) )
+    {
+        cerr << "ERROR: HeldKarp takes 1 to " << EXHAUSTIVE_MAXOBJ
+        << " objectives and 2 to " << HELDKARP_MAXNODES << " nodes." << endl;
+        exit( 1 );
+    }
+
+    for ( int k = 0; k < nobj; k++ )
+        costs[ k ] = graph.get_costs( which[ k ] );
+}
+
+/**
+ * HeldKarp destructor.
+ */
+HeldKarp::~HeldKarp ( void )
+{
+}
+
+/**
+ * The state of subset s (of nodes 1..m, bit j for node j + 1) ending at
+ * node j + 1, which must be in s.
+ */
+inline uint32_t
+HeldKarp::state ( uint32_t s, int j ) const
+{
+    return base[ pos[ s ] ] + __builtin_popcount( s & ( ( 1u << j ) - 1 ) );
+}
+
+/**
+ * Find the best tours, and leave them in front.
+ */
+void
+HeldKarp::solve ( void )
+{
+    uint32_t nsets = 1u << m;
+
+    // Subsets by layer, each layer in increasing order (Gosper's hack).
+    order.resize( nsets );
+    layer.resize( m + 2 );
+    pos.resize( nsets );
+    base.resize( nsets + 1 );
+    order[ 0 ] = 0;
+    layer[ 0 ] = 0;
+    layer[ 1 ] = 1;
+
+    for ( int k = 1, p = 1; k <= m; k++ )
+    {
+        uint32_t s = ( 1u << k ) - 1;
+
+        while ( s < nsets )
+        {
+            order[ p++ ] = s;
+            uint32_t c = s & -s;
+            uint32_t r = s + c;
+            s = ( ( ( r ^ s ) >> 2 ) / c ) | r;
+        }
+
+        layer[ k + 1 ] = p;
+    }
+
+    base[ 0 ] = 0;
+
+    for ( uint32_t p = 0; p < nsets; p++ )
+    {
+        pos[ order[ p ] ] = p;
+        base[ p + 1 ] = base[ p ] + __builtin_popcount( order[ p ] );
+    }
+
+    states = base[ nsets ];
+    front.clear();
+
+    if ( 1 == nobj )
+        solve_single();
+    else
+        solve_pareto();
+}
+
+/**
+ * One objective: one cost per state.
+ */
+void
+HeldKarp::solve_single ( void )
+{
+    const double* c = costs[ 0 ];
+    vector<double> dp( states );
+    uint32_t full = ( 1u << m ) - 1;
+
+    for ( int j = 0; j < m; j++ )
+        dp[ state( 1u << j, j ) ] = c[ j + 1 ];
+
+    for ( int k = 2; k <= m; k++ )
+    {
+        #pragma omp parallel for schedule(static)
+        for ( int p = layer[ k ]; p < ( int ) layer[ k + 1 ]; p++ )
+        {
+            uint32_t s = order[ p ];
+            double* out = &dp[ base[ p ] ];
+
+            for ( uint32_t js = s; js; js &= js - 1 )
+            {
+                int j = __builtin_ctz( js );
+                uint32_t r = s ^ ( 1u << j );
+                const double* in = &dp[ base[ pos[ r ] ] ];
+                const double* to = c + j + 1;
+                double best = INF;
+                int rank = 0;
+
+                for ( uint32_t is = r; is; is &= is - 1, rank++ )
+                {
+                    int i = __builtin_ctz( is );
+                    double d = in[ rank ] + to[ ( i + 1 ) * n ];
+
+                    if ( d < best )
+                        best = d;
+                }
+
+                *out++ = best;
+            }
+        }
+    }
+
+    // The best last node, then walk back to node 0.
+    ExhaustiveTour t;
+    int j = 0;
+
+    for ( int k = 1; k < m; k++ )
+        if ( dp[ state( full, k ) ] < dp[ state( full, j ) ] )
+            j = k;
+
+    t.obj[ 0 ] = dp[ state( full, j ) ];
+    t.obj[ 1 ] = 0.0;
+    t.order.resize( n );
+    t.order[ 0 ] = 0;
+
+    for ( uint32_t s = full; ; )
+    {
+        int k = __builtin_popcount( s );
+        uint32_t r = s ^ ( 1u << j );
+
+        t.order[ k ] = j + 1;
+
+        if ( 0 == r )
+            break;
+
+        // The predecessor is whichever i gives this state's cost.
+        double here = dp[ state( s, j ) ];
+
+        for ( uint32_t is = r; is; is &= is - 1 )
+        {
+            int i = __builtin_ctz( is );
+
+            if ( dp[ state( r, i ) ] + c[ ( i + 1 ) * n + j + 1 ] == here )
+            {
+                j = i;
+                break;
+            }
+        }
+
+        s = r;
+    }
+
+    front.push_back( t );
+}
+
+/**
+ * Two objectives: a Pareto set of labels per state, kept in one pool.
+ */
+void
+HeldKarp::solve_pareto ( void )
+{
+    const double* cx = costs[ 0 ];
+    const double* cy = costs[ 1 ];
+    vector<HeldKarpLabel> pool;
+    vector<uint32_t> first( states + 1 );   // each state's first label
+    uint32_t full = ( 1u << m ) - 1;
+
+    first[ 0 ] = 0;
+
+    for ( int j = 0; j < m; j++ )
+    {
+        HeldKarpLabel l = { cx[ j + 1 ], cy[ j + 1 ], 0, -1 };
+        pool.push_back( l );
+        first[ j + 1 ] = j + 1;
+    }
+
+    for ( int k = 2; k <= m; k++ )
+    {
+        uint32_t s0 = base[ layer[ k ] ];
+        uint32_t ns = base[ layer[ k + 1 ] ] - s0;
+        vector< vector<HeldKarpLabel> > out( ns );
+
+        #pragma omp parallel
+        {
+            vector<HeldKarpLabel> cand;
+
+            #pragma omp for schedule(dynamic, 64)
+            for ( int p = layer[ k ]; p < ( int ) layer[ k + 1 ]; p++ )
+            {
+                uint32_t s = order[ p ];
+                uint32_t slot = base[ p ] - s0;
+
+                for ( uint32_t js = s; js; js &= js - 1, slot++ )
+                {
+                    int j = __builtin_ctz( js );
+                    uint32_t r = s ^ ( 1u << j );
+
+                    cand.clear();
+
+                    for ( uint32_t is = r; is; is &= is - 1 )
+                    {
+                        int i = __builtin_ctz( is );
+                        uint32_t from = state( r, i );
+                        double dx = cx[ ( i + 1 ) * n + j + 1 ];
+                        double dy = cy[ ( i + 1 ) * n + j + 1 ];
+
+                        for ( uint32_t q = first[ from ]; q < first[ from + 1 ]; q++ )
+                        {
+                            HeldKarpLabel l = { pool[ q ].x + dx, pool[ q ].y + dy, q, i };
+                            cand.push_back( l );
+                        }
+                    }
+
+                    pareto_filter( cand );
+                    out[ slot ] = cand;
+                }
+            }
+        }
+
+        for ( uint32_t t = 0; t < ns; t++ )
+        {
+            pool.insert( pool.end(), out[ t ].begin(), out[ t ].end() );
+            first[ s0 + t + 1 ] = ( uint32_t ) pool.size();
+        }
+    }
+
+    labels = ( long long ) pool.size();
+
+    // Every label of the full states, filtered again.
+    vector<HeldKarpLabel> ends;
+
+    for ( int j = 0; j < m; j++ )
+    {
+        uint32_t st = state( full, j );
+
+        for ( uint32_t q = first[ st ]; q < first[ st + 1 ]; q++ )
+        {
+            HeldKarpLabel l = pool[ q ];
+            l.prev = q;
+            l.from = j;
+            ends.push_back( l );
+        }
+    }
+
+    pareto_filter( ends );
+
+    for ( size_t e = 0; e < ends.size(); e++ )
+    {
+        ExhaustiveTour t;
+        uint32_t q = ends[ e ].prev;
+        int j = ends[ e ].from;
+
+        t.obj[ 0 ] = ends[ e ].x;
+        t.obj[ 1 ] = ends[ e ].y;
+        t.order.resize( n );
+        t.order[ 0 ] = 0;
+
+        for ( int k = m; k >= 1; k-- )
+        {
+            t.order[ k ] = j + 1;
+            j = pool[ q ].from;
+            q = pool[ q ].prev;
+        }
+
+        front.push_back( t );
+    }
+}
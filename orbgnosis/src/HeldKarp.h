@@ -0,0 +1,112 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Held-Karp dynamic programming for the best tours of a Graph.
+ */
+
+#ifndef _HELDKARP_H_
+#define _HELDKARP_H_
+#include "Exhaustive.h"
+#include "Graph.h"
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+#define HELDKARP_MAXNODES 21    //!< node 0 and 20 others, 2^20 subsets.
+
+/**
+ * One label of the two objective program: the costs of one nondominated
+ * path to a (subset, last node) state, and where it came from.
+ */
+struct HeldKarpLabel
+{
+    double x;       //!< first objective.
+    double y;       //!< second objective.
+    uint32_t prev;  //!< the label it extends, in the previous layer.
+    int from;       //!< the node before the last, or -1 for node 0.
+};
+
+/**
+ * Exact best tours of a Graph, by Held-Karp dynamic programming, for the
+ * same problem as Exhaustive: start at node 0 and visit every other node
+ * once.  The best path to each (set of nodes visited, last node) state
+ * only depends on the best paths to the states one node smaller, so
+ * there are n 2^n states instead of n! tours.
+ *
+ * States are worked out a layer at a time, layer k holding the subsets
+ * of k nodes.  Every state of a layer only reads the layer before, so
+ * each layer is spread across threads.  A state's slot only exists for
+ * last nodes in its subset, which halves the table: for 21 nodes, one
+ * objective takes about 100 MB.  Tours are recovered by walking back
+ * through the table, so there is no table of predecessors.
+ *
+ * With two objectives each state holds its whole Pareto set of labels
+ * instead of one cost, and the answer is the exact Pareto set of tours.
+ * Memory then goes with the number of labels, which depends on the graph.
+ *
+ * The results are in the same form as Exhaustive's.  Between tours which
+ * tie, the one kept may differ from Exhaustive's.
+ */
+class HeldKarp
+{
+
+    public:
+        HeldKarp ( const Graph&,            // the graph
+                   int,                     // number of objectives
+                   const graph_cost* );     // the cost of each objective
+
+        virtual ~HeldKarp ( void );
+
+        void solve ( void );
+
+        vector<ExhaustiveTour> front;   //!< best tours, by obj[0].
+        long long states;               //!< (subset, last node) states.
+        long long labels;               //!< labels kept, two objectives.
+
+    private:
+        void solve_single ( void );
+        void solve_pareto ( void );
+        uint32_t state ( uint32_t, int ) const;
+
+        const Graph& graph;         //!< the graph.
+        int n;                      //!< its number of nodes.
+        int m;                      //!< nodes other than 0.
+        int nobj;                   //!< number of objectives.
+        const double* costs[ EXHAUSTIVE_MAXOBJ ];   //!< each one's matrix.
+
+        vector<uint32_t> order;     //!< every subset, by layer.
+        vector<uint32_t> layer;     //!< where each layer starts in order.
+        vector<uint32_t> pos;       //!< each subset's place in order.
+        vector<uint32_t> base;      //!< each place's first state.
+};
+
+#endif /* _HELDKARP_H_ */
@@ -29,6 +29,9 @@
 *                  David Vallado <valldodl@worldnet.att.net>
 */
 
+#ifndef _HITEARTH_H_
+#define _HITEARTH_H_
+
 #include "Orbgnosis.h"
 // maybe... #include "Traj.h"
 #include "Vec3.h"
@@ -44,7 +47,7 @@ using namespace std;
  * @param v2 final velocity, type Vec3.
  */
 inline bool
-hit_Earth (const Vec3 r1, const Vec3 r2, const Vec3 v1, const Vec3 v2)
+hit_Earth (const Vec3& r1, const Vec3& r2, const Vec3& v1, const Vec3& v2)
 {
     //cout << "hit_Earth() is checking...";
     // Are the inital or final points inside the Earth?
@@ -92,3 +95,5 @@ hit_Earth (const Vec3 r1, const Vec3 r2, const Vec3 v1, const Vec3 v2)
     //cout << "miss." << endl;
     return false;
 }
+
+#endif /* _HITEARTH_H_ */
@@ -29,32 +29,46 @@
 *                  David Vallado <valldodl@worldnet.att.net>
 */
 
+#ifndef _KEPLER_H_
+#define _KEPLER_H_
+
+#include "Anomaly.h"
 #include "Orbgnosis.h"
+#include "SolverStats.h"
 #include "Stumpff.h"
+#include "Timer.h"
 #include "Traj.h"
+#include "TrajState.h"
 #include "Vec3.h"
 #include <iostream>
 #include <math.h>
+#include <stdlib.h>
 
 using namespace std;
 
 /**
- * Solve Kepler's problem.  Given a state vector (Traj) and a time interval,
+ * Solve Kepler's problem.  Given a state vector and a time interval,
  * find the state vector after the time interval has elapsed.  This function
  * calculates r and v vectors and does not consider J2.
- * @param traj_0 the initial trajectory at time zero.
+ * @param state_0 the initial state.
  * @param t amount of time, in canonical units.
+ * @param iterations if not NULL, gets the number of iterations used, even
+ * if kepler_state() throws.
+ * @return the state at state_0.t + t.
  *
- * kepler() will throw an integer exception in some cases:
+ * kepler_state() will throw an integer exception in some cases:
  * If it exceeds the iteration limit it throws 1.
  * If it converges, but the F&G transformation is out of tolerance, it throws
  * a 2.
- * Obviously, programmers are encouraged to wrap calls to kepler()
+ * Obviously, programmers are encouraged to wrap calls to kepler_state()
  * in a try-catch block.
  */
-Traj
-kepler ( Traj traj_0, double t )
+inline TrajState
+kepler_state ( const TrajState& state_0, double t, int* iterations = NULL )
 {
+    if ( NULL != iterations )
+        *iterations = 0;
+
     if (t < 0)
     {
         cout << "Kepler needs time > 0." << endl;
@@ -64,17 +78,18 @@ kepler ( Traj traj_0, double t )
     if ( fabs( t ) <= SMALL )
     {
         cout << "Kepler: time was zero.  No movement." << endl;
-        return traj_0; // Zero time, so no movement.
+        return state_0; // Zero time, so no movement.
     }
     else
     {
         // set up local variables
+        const double t_in = t;  // the caller's time, before any multirev cut
         double r0, v0;  // initial radius and velocity (magnitudes only)
         Vec3 rfinal, vfinal;      // final radius and velocity (vectors)
         double F, G;    // universal variable f and g expressions
         double Fdot, Gdot; // F and G's rates of change
         double Xold;    // universal variable
-        double Xnew;    // universal variable
+        double Xnew = 0.0;    // universal variable
         double Xold2;   // Xold squared
         double Xnew2;   // Xnew squared
         double Znew;    // new value of Z
@@ -87,23 +102,26 @@ kepler ( Traj traj_0, double t )
         double ksi;     // specific mechanical energy
         double period;  // orbital period
         double S, W;    // variables for parabolic special case
-        double Rval;
+        double Rval;    // radius, dt/dX
+        double dRval;   // dRval/dX
         double temp;
-        double adjust;  // variable step adjuster.
         int counter = 0;
-        int adj_ctr = 0;
-        const int limit = 400;  // iteration limit (default = 40)
-        Traj result;
-
-        r0 = norm( traj_0.get_r() ); // current radius
-        v0 = norm( traj_0.get_v() ); // current velocity
+        int adj_ctr = 0;        // negative radicands
+        const int limit = KEPLER_MAXITER;   // iteration limit
+        TrajState result;
+        SolverStats* stats = solver_stats;  // this thread's statistics, if any.
+        double start_time = ( NULL != stats ) ? wall_time() : 0.0;
+        solver_regime regime = REGIME_ELLIPTIC;
+
+        r0 = norm( state_0.r ); // current radius
+        v0 = norm( state_0.v ); // current velocity
         Xold = 0.0;
         Znew = 0.0;
-        rdotv = dot( traj_0.get_r(), traj_0.get_v() );
+        rdotv = dot( state_0.r, state_0.v );
 
         ksi = ( 0.5 * v0 * v0 ) - ( 1.0 / r0 );     // canonical!
         alpha = -2.0 * ksi;
-        a = traj_0.get_a();
+        a = -1.0 / ( 2.0 * ksi );
 
         // Set up initial guess for Xold.
 
@@ -118,17 +136,15 @@ kepler ( Traj traj_0, double t )
                 t = fmod ( t, period ); // multirev
             }
 
-            if ( fabs( alpha - 1.0 ) > 0.5 )
-                Xold = t * alpha;
-            else
-                Xold = t * alpha * 0.97; // first guess can't be too close
+            Xold = t * alpha;
         } else
         {
             if ( fabs(alpha) < 0.0001 ) // was (fabs(alpha) < SMALL )
             {
                 // Parabola
                 //cout << "**** Kepler is working on a parabola ****" << endl;
-                double h = norm( traj_0.get_h_vector() );
+                regime = REGIME_PARABOLIC;
+                double h = norm( cross( state_0.r, state_0.v ) );
                 double p = h * h;
                 S = 0.5 * ( M_PI / 2.0 - atan( 3.0 * sqrt( 1.0 / ( p * p * p ) ) * t ));
                 W = atan( pow( tan(S), 1.0 / 3.0 ) );
@@ -139,53 +155,59 @@ kepler ( Traj traj_0, double t )
                 // Hyperbola
                 // This only works correctly for positive t.
                 //cout << "**** Kepler is working on a hyperbola ****" << endl;
+                regime = REGIME_HYPERBOLIC;
                 temp = -2.0 * t /
                        ( a * ( rdotv + sqrt( -a ) * ( 1.0 - r0 * alpha ) ) );
                 Xold = sqrt( -a ) * log( temp );
             }
         }
 
-        while ( 1 )    // XXX ugly loop
+        // Laguerre-Conway iteration on the universal variable (Conway,
+        // "An Improved Algorithm Due to Laguerre for the Solution of
+        // Kepler's Equation", 1986).  With n = 5 it converges from any
+        // starter for an ellipse, cubically near the root, and needs no
+        // step adjustment on the long elliptic transfers that used to
+        // send Newton's method wandering.
+        while ( 1 )
         {
             Xold2 = Xold * Xold;
             Znew = Xold2 * alpha;
             C2new = stumpff_C2( Znew );
             C3new = stumpff_C3( Znew );
 
+            // F(X) = tnew - t, F'(X) = Rval and F''(X) = dRval / dX
             tnew = Xold2 * Xold * C3new + rdotv * Xold2 * C2new +
                    r0 * Xold * ( 1.0 - Znew * C3new );
 
             Rval = Xold2 * C2new + rdotv * Xold * ( 1.0 - Znew * C3new ) +
                    r0 * ( 1.0 - Znew * C2new );
 
-            if ((a > 0.0) &&
-                    (fabs(Xnew) > 2*M_PI*sqrt(a)) &&
-                    (ksi < 0.0))
+            dRval = rdotv * ( 1.0 - Znew * C2new ) +
+                    ( 1.0 - alpha * r0 ) * Xold * ( 1.0 - Znew * C3new );
+
+            // The radicand is never negative for an ellipse.  Should
+            // roundoff make it so, take its magnitude (Conway's rule).
+            temp = 16.0 * Rval * Rval - 20.0 * ( tnew - t ) * dRval;
+            if ( temp < 0.0 )
             {
-                /* XXX
-                 * This adjusts the step size if things are going badly.
-                 * Rval is multiplied by a random number between 7 and 10.
-                 * Why random?  Because I can't think of a good constant value.
-                 * Vallado recommends 7 to 10.
-                 */
-                adjust = 3.0 * ((double)rand() / ((double)(RAND_MAX) + (double)(1))) + 7.0;
-                Xnew = Xold + (t - tnew) / (Rval * adjust);
+                temp = -temp;
                 adj_ctr++;
             }
 
-            else
-            {
-                Xnew = Xold + ( t - tnew ) / Rval;
-            }
+            temp = ( Rval >= 0.0 ) ? Rval + sqrt( temp )
+                                   : Rval - sqrt( temp );
+            Xnew = Xold - 5.0 * ( tnew - t ) / temp;
 
             counter++;
-            //cout << tnew-t << endl;
             Xold = Xnew;
 
             if (( fabs( tnew - t ) < SMALL ) || ( counter >= limit ))
                 break;
         }  // end while
 
+        if ( NULL != iterations )
+            *iterations = counter;
+
         // Update Znew, C2new and C3new!
         // Vallado's original code doesn't have this.
         // Not doing this will cause small errors,
@@ -208,26 +230,116 @@ kepler ( Traj traj_0, double t )
 
         G = t - Xnew2 * Xnew * C3new;
 
-        rfinal = F * traj_0.get_r() + G * traj_0.get_v();
+        rfinal = F * state_0.r + G * state_0.v;
 
         Gdot = 1.0 - ( Xnew2 * C2new / norm( rfinal ) );
 
         Fdot = ( Xnew / ( r0 * norm( rfinal ) ) ) * ( Znew * C3new - 1.0 );
 
-        vfinal = Fdot * traj_0.get_r() + Gdot * traj_0.get_v();
+        vfinal = Fdot * state_0.r + Gdot * state_0.v;
 
         temp = F * Gdot - Fdot * G;
 
+        if ( NULL != stats )
+        {
+            stats->kepler_call( regime, wall_time() - start_time, counter,
+                                ( counter >= limit ) ? FAIL_ITERATION_LIMIT
+                                : ( fabs( temp - 1.0 ) > 0.00001 ) ? FAIL_FG_TOLERANCE
+                                : FAIL_NONE, adj_ctr );
+        }
+
         if ( counter >= limit )
             throw(1);
 
         if ( fabs( temp - 1.0 ) > 0.00001 )
             throw(2);
 
-        // Traj constructor automatically takes care of classical elements.
-        result = Traj (rfinal, vfinal);
-        //result.do_J2_regression(t);
+        // For J2, see kepler_J2().
+        result.r = rfinal;
+        result.v = vfinal;
+        result.t = state_0.t + t_in;
 
         return result;
     }
 }
+
+/**
+ * Solve Kepler's problem for a Traj.  See kepler_state(), which this
+ * wraps, for the details and the exceptions it throws.
+ * @param traj_0 the initial trajectory at time zero.
+ * @param t amount of time, in canonical units.
+ * @param iterations if not NULL, gets the number of iterations used.
+ */
+inline Traj
+kepler ( Traj traj_0, double t, int* iterations = NULL )
+{
+    TrajState s = kepler_state( traj_state( traj_0, 0.0 ), t, iterations );
+
+    if ( fabs( t ) <= SMALL )
+        return traj_0;  // Zero time, so no movement.
+
+    // Traj constructor automatically takes care of classical elements.
+    return Traj( s.r, s.v );
+}
+
+/**
+ * Propagate an orbit with the secular effects of J2: the node regresses,
+ * the apsides rotate and the mean motion changes, at the constant rates
+ * Traj::find_J2_rates() works out.  a, e and i don't change.  The elements
+ * of traj_0 are taken as mean elements, and no short-period terms are
+ * added, so this is good for planning over days, not for precise ephemeris.
+ *
+ * It is as cheap as kepler(): one solution of Kepler's equation and one
+ * elements-to-state conversion, with no iteration on the state vector.
+ * Open orbits have no secular theory and go to kepler(), which may throw.
+ * @param traj_0 the initial trajectory at time zero.
+ * @param t amount of time, in canonical units.
+ */
+inline TrajState
+kepler_J2 ( Traj& traj_0, double t )
+{
+    double e = traj_0.get_e();
+    double M, f;    // mean and true anomaly at t
+    TrajState s;
+
+    if ( e >= 1.0 )
+        return kepler_state( traj_state( traj_0, 0.0 ), t );
+
+    M = fmod( traj_0.get_M() + traj_0.get_M_dot() * t, 2.0 * M_PI );
+    mean_to_true( 1, &M, &e, &f );
+
+    elements_to_rv( traj_0.get_a(), e, traj_0.get_i(),
+                    fmod( traj_0.get_raan() + traj_0.get_raan_dot() * t, 2.0 * M_PI ),
+                    fmod( traj_0.get_w() + traj_0.get_w_dot() * t, 2.0 * M_PI ), f,
+                    s.r, s.v );
+    s.t = t;
+    return s;
+}
+
+/**
+ * How targets are propagated, chosen once per run.
+ */
+enum propagator
+{
+    PROPAGATE_TWO_BODY,     //!< kepler(), the default.
+    PROPAGATE_SECULAR_J2    //!< kepler_J2().
+};
+
+extern propagator target_propagator;  //!< set once, before any propagation.
+
+/**
+ * Propagate a target with the run's propagator.
+ * @param traj_0 the initial trajectory at time zero.
+ * @param t amount of time, in canonical units.
+ * @return the target's state at t.
+ */
+inline TrajState
+propagate ( Traj& traj_0, double t )
+{
+    if ( PROPAGATE_SECULAR_J2 == target_propagator )
+        return kepler_J2( traj_0, t );
+
+    return kepler_state( traj_state( traj_0, 0.0 ), t );
+}
+
+#endif /* _KEPLER_H_ */
@@ -0,0 +1,164 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Lambert solver strategies, for code that is compiled once per solver.
+ *
+ * A strategy wraps one or more Lambert solver objects behind the same
+ * small interface:
+ *
+ *   void setup ( Vec3 Ro, Vec3 R, double t );   // once per leg
+ *   void solve ( bool longway, int revs );      // once per branch
+ *   bool isFailure ( void );
+ *   Vec3 getVo ( void );
+ *   Vec3 getV ( void );
+ *   static const char* name ( void );
+ *
+ * best_transfer() and the wsp_astro evaluator are templates over the
+ * strategy, so the choice of solver is made once, outside the hot loop,
+ * rather than on every solve.  To add a solver, write a strategy for it,
+ * add a lambert_method, and add a case to each runtime selector (see
+ * test_problem() in Orbgnosis.cpp).
+ */
+
+#ifndef _LAMBERTSOLVER_H_
+#define _LAMBERTSOLVER_H_
+#include "Vec3.h"
+#include "BLambert.h"
+#include "ULambert.h"
+
+/**
+ * Which Lambert solver strategy to use, picked at run time.
+ */
+enum lambert_method
+{
+    LAMBERT_UNIVERSAL,  //!< UniversalSolver, the default.
+    LAMBERT_BATTIN      //!< BattinSolver.
+};
+
+/**
+ * The universal variables solver, for every branch.  When warm, each
+ * zero-rev branch is seeded with the psi that branch found on the last
+ * leg, which pays off when consecutive legs are close (a porkchop row).
+ */
+struct UniversalSolver
+{
+    ULambert xfer;      //!< the solver.
+    bool warm;          //!< seed zero-rev branches from the last leg.
+    double psi[ 2 ];    //!< last zero-rev psi, short way and long way.
+    bool have[ 2 ];     //!< ... if that branch converged.
+
+    UniversalSolver ( void ) : xfer(), warm( false )
+    {
+        cool();
+    }
+
+    inline void setup ( Vec3 Ro, Vec3 R, double t )
+    {
+        xfer.setRo( Ro );
+        xfer.setR( R );
+        xfer.sett( t );
+    }
+
+    inline void solve ( bool longway, int revs )
+    {
+        if ( ! warm || ( 0 != revs ) )
+        {
+            xfer.clearSeed();
+            xfer.universal( longway, revs );
+            return;
+        }
+
+        if ( have[ longway ] )
+            xfer.setSeed( psi[ longway ] );
+        else
+            xfer.clearSeed();
+
+        xfer.universal( longway, revs );
+        psi[ longway ] = xfer.getPsi();
+        have[ longway ] = ! xfer.isFailure();
+    }
+
+    // Forget the seeds, so the next leg starts cold.
+    inline void cool ( void )
+    {
+        psi[ 0 ] = psi[ 1 ] = 0.0;
+        have[ 0 ] = have[ 1 ] = false;
+    }
+
+    inline bool isFailure ( void ) { return xfer.isFailure(); }
+    inline Vec3 getVo ( void ) { return xfer.getVo(); }
+    inline Vec3 getV ( void ) { return xfer.getV(); }
+    static const char* name ( void ) { return "universal"; }
+};
+
+/**
+ * Battin's method for zero-rev branches.  It has no multi-rev option, so
+ * those still go to the universal variables solver.
+ */
+struct BattinSolver
+{
+    BLambert zero;  //!< zero-rev solver.
+    ULambert multi; //!< multi-rev solver.
+    bool multirev;  //!< which of the two solved last.
+
+    BattinSolver ( void ) : multirev( false ) {}
+
+    inline void setup ( Vec3 Ro, Vec3 R, double t )
+    {
+        zero.setRo( Ro );
+        zero.setR( R );
+        zero.sett( t );
+        multi.setRo( Ro );
+        multi.setR( R );
+        multi.sett( t );
+    }
+
+    inline void solve ( bool longway, int revs )
+    {
+        multirev = ( revs > 0 );
+
+        if ( multirev )
+            multi.universal( longway, revs );
+        else
+            zero.battin( longway );
+    }
+
+    inline bool isFailure ( void )
+    {
+        return multirev ? multi.isFailure() : zero.isFailure();
+    }
+
+    inline Vec3 getVo ( void ) { return multirev ? multi.getVo() : zero.getVo(); }
+    inline Vec3 getV ( void ) { return multirev ? multi.getV() : zero.getV(); }
+    static const char* name ( void ) { return "battin"; }
+};
+
+#endif /* _LAMBERTSOLVER_H_ */
@@ -0,0 +1,157 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include <stddef.h>
+#include "LegTrie.h"
+
+using namespace std;
+
+LegTrie* leg_trie = NULL;
+
+/**
+ * LegTrie constructor, an empty trie.
+ */
+LegTrie::LegTrie ( void ) :
+        shared( 0 ),
+        priced( 0 )
+{
+    clear();
+}
+
+/**
+ * LegTrie destructor.
+ */
+LegTrie::~LegTrie ( void )
+{
+}
+
+/**
+ * Make room for legs up front, so that insert() never has to grow the
+ * trie during evaluation.  clear() keeps the room.
+ * @param legs how many legs, the root not included.
+ */
+void
+LegTrie::reserve ( int legs )
+{
+    nodes.reserve( legs + 1 );
+}
+
+/**
+ * Forget every leg, leaving just the root.  The totals are kept.
+ */
+void
+LegTrie::clear ( void )
+{
+    LegNode root;
+
+    root.end = 0;
+    root.dwell = 0.0;
+    root.tof = 0.0;
+    root.status = LEG_PRICED;
+    root.dv = 0.0;
+    root.child = -1;
+    root.sibling = -1;
+
+    nodes.clear();
+    nodes.push_back( root );
+}
+
+/**
+ * Look for a leg already priced for this prefix.  Genes are compared
+ * exactly; a leg is only shared if it would be priced identically.
+ * @param parent node of the leg before, 0 for the first leg.
+ * @param end end node of this leg.
+ * @param dwell dwell before this leg.
+ * @param tof time of flight of this leg.
+ * @return the leg's node, or -1 if it hasn't been priced.
+ */
+int
+LegTrie::find ( int parent, int end, double dwell, double tof )
+{
+    for ( int n = nodes[ parent ].child; n >= 0; n = nodes[ n ].sibling )
+    {
+        if ( ( nodes[ n ].end == end ) && ( nodes[ n ].dwell == dwell )
+                && ( nodes[ n ].tof == tof ) )
+        {
+            shared++;
+            return n;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Add a priced leg under its prefix.
+ * @param parent node of the leg before, 0 for the first leg.
+ * @param end end node of this leg.
+ * @param dwell dwell before this leg.
+ * @param tof time of flight of this leg.
+ * @param status what became of it.
+ * @param dv its delta-V.
+ * @return the new node.
+ */
+int
+LegTrie::insert ( int parent, int end, double dwell, double tof,
+                  leg_status status, double dv )
+{
+    LegNode leg;
+
+    leg.end = end;
+    leg.dwell = dwell;
+    leg.tof = tof;
+    leg.status = status;
+    leg.dv = dv;
+    leg.child = -1;
+    leg.sibling = nodes[ parent ].child;
+
+    nodes.push_back( leg );
+    nodes[ parent ].child = (int)nodes.size() - 1;
+    priced++;
+    return nodes[ parent ].child;
+}
+
+/**
+ * What became of the leg at a node.
+ */
+leg_status
+LegTrie::get_status ( int n )
+{
+    return nodes[ n ].status;
+}
+
+/**
+ * Delta-V of the leg at a node.
+ */
+double
+LegTrie::get_dv ( int n )
+{
+    return nodes[ n ].dv;
+}
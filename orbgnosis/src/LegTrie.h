@@ -0,0 +1,103 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#ifndef _LEGTRIE_H_
+#define _LEGTRIE_H_
+#include <vector>
+
+using namespace std;
+
+/**
+ * What became of one leg of a tour.
+ */
+enum leg_status
+{
+    LEG_PRICED,         //!< priced; the delta-V may still be INF.
+    LEG_KEPLER_FAILED,  //!< kepler() threw, the tour is abandoned.
+    LEG_HOPELESS        //!< not priced, its bound got the tour pruned.
+};
+
+/**
+ * The legs already priced for one population, keyed by tour prefix.
+ * A leg's cost depends on every gene before it: where the tour has been,
+ * and the dwell and TOF of each leg so far, which fix the departure time.
+ * So each node of the trie is one leg, keyed by its end node, dwell and
+ * TOF, under the node of the leg before it.  Individuals which share a
+ * prefix share its nodes, and each distinct prefix leg is priced once.
+ *
+ * Node 0 is the root, the chaser before the first leg.  Children are kept
+ * as a linked list of siblings; a node seldom has more than a few.
+ */
+class LegTrie
+{
+
+    public:
+        LegTrie ( void );
+        ~LegTrie ( void );
+
+        void clear ( void );    // forget every leg, keep the totals.
+        void reserve ( int );   // room for this many legs, before they come.
+
+        // The child of a node for the next leg, -1 if it isn't there yet.
+        int find ( int,        // node of the leg before
+                   int,        // end node of this leg
+                   double,     // dwell before this leg
+                   double );   // TOF of this leg
+
+        // Add a leg, returns its node.
+        int insert ( int, int, double, double, leg_status, double );
+
+        leg_status get_status ( int );
+        double get_dv ( int );
+
+        long shared;    //!< legs found by find(), over the whole run.
+        long priced;    //!< legs added by insert(), over the whole run.
+
+    private:
+        /**
+         * One leg.
+         */
+        struct LegNode
+        {
+            int end;            //!< end node of the leg.
+            double dwell;       //!< dwell before the leg.
+            double tof;         //!< time of flight of the leg.
+            leg_status status;  //!< what became of it.
+            double dv;          //!< its delta-V, ER/TU.
+            int child;          //!< first child, -1 if none.
+            int sibling;        //!< next sibling, -1 if none.
+        };
+
+        vector<LegNode> nodes;  //!< node 0 is the root.
+};
+
+extern LegTrie* leg_trie;  //!< the evaluator's trie, NULL to price every leg.
+
+#endif /* _LEGTRIE_H_ */
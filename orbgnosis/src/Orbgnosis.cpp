@@ -40,13 +40,22 @@
 #include "Traj.h"
 #include "Graph.h"
 #include "HitEarth.h"
+#include "EvalMemo.h"
+#include "HeldKarp.h"
 #include "Kepler.h"
+#include "LegTrie.h"
+#include "RK78.h"
 #include "ULambert.h"
 #include "Orbgnosis.h"
+#include "RunStats.h"
 #include "Tour.h"
+#include "Timer.h"
+#include "TourBB.h"
+#include "Transfer.h"
 #include "Vec3.h"
 
 # include <math.h>
+# include <string.h>
 # include <unistd.h>
 # include "global.h"
 # include "rand.h"
@@ -73,6 +82,13 @@ int nbinmut;
 int nrealmut;
 int nbincross;
 int nrealcross;
+int nperm;
+double pcross_perm;
+double pmut_perm;
+int perm_cross_type;
+int npermcross;
+int npermmut;
+int *perm_work;         // permcross() scratch, nperm ints.
 int *nbits;
 double *min_realvar;
 double *max_realvar;
@@ -86,19 +102,56 @@ int obj3;
 int angle1;
 int angle2;
 
-// declare externs
-extern Tour mytour(TARGETS);
-extern Graph mygraph(TARGETS + 1);
-extern Constellation mycon(TARGETS + 1);  // constellation also has chaser.
+// Early termination of hopeless tours; see tour_pruned().
+int prune = 0;          // 1 to abandon a tour once it can't matter.
+int front_size = 0;     // how many points bound_front holds.
+double *bound_front;    // obj[0], obj[1] of the feasible first front.
+
+// Tour prefix sharing; see LegTrie.
+int share = 1;          // 1 to price each distinct prefix leg only once.
+
+// Run-level evaluation memo; see EvalMemo.
+int memo = 1;               // 1 to never evaluate a chromosome twice.
+double memo_quantum = 0.0;  // rounding of real variables in the memo key.
+int eval_pruned;            // set by test_problem if it pruned the tour.
+int nuntouched;             // children which needed no evaluation.
+
+// Post-processing check of the final front; see validate_front().
+#define RK78_TOL 1.0e-10    // RK78 error tolerance per step (ER, ER/TU).
+int validate = 0;           // 1 to re-fly the final front numerically.
+double drag_coeff = 0.0;    // Cd A / m (m^2/kg) of the chaser, 0 for no drag.
+
+// Post-processing exact front on a time grid; see exact_front().
+double exact_step = 0.0;    // grid step (TU), 0 for no exact front.
+
+// The problem, sized once the options are read.
+int targets = DEFAULT_TARGETS;  // targets per tour, chaser not included.
+Tour *mytour = NULL;            // every tour order, from node 0.
+Graph *mygraph = NULL;          // the wsp1 and wsp2 nodes.
+Constellation *mycon = NULL;    // constellation also has chaser.
 
 
 // # define wsp1           /* Static wandering salesman problem, 1 objective */
 // # define wsp2           /* Static wandering salesman problem, 2 objectives */
 # define wsp_astro        /* Dynamic wsp where nodes are satellites */
 
+/**
+ * The node visited at step c of a tour.  Every tour starts at node 0.
+ * A permutation chromosome lists the other nodes (less one) directly;
+ * otherwise the real-coded key picks a row of mytour.
+ */
+inline int
+tour_node (int key, const int *perm, int c)
+{
+    if (nperm != 0)
+        return (0 == c) ? 0 : perm[c - 1] + 1;
+
+    return mytour->get_target(key, c);
+}
+
 // Single objective = total length of the tour.
 #ifdef wsp1
-void test_problem (double *xreal, double *xbin, int **gene, double *obj, double *constr)
+void test_problem (double *xreal, double *xbin, int **gene, int *perm, double *obj, double *constr)
 {
     /*
      * Add up the length of the Hamiltonian path, going in the order
@@ -113,14 +166,15 @@ void test_problem (double *xreal, double *xbin, int **gene, double *obj, double
      * Steinhaus-Johnson-Trotter ordering of the permutation data files.. i.e.
      * adjacent permutation differ by exactly one transposition.  It's a kind
      * of combinatoric gray coding.
+     * With a permutation chromosome the key isn't used.
      */
     int key;        // the corresponding row number in mytour.
-    key = (int)xreal[0];  // convert double to int.
-    for (int c = 0; c < mytour.cols - 1; c++) // always start at node #0
+    key = (nperm != 0) ? 0 : (int)xreal[0];  // convert double to int.
+    for (int c = 0; c < targets; c++) // always start at node #0
     {
-        start = mytour.get_target(key, c);    // initially, mytour column 0
-        end = mytour.get_target(key, c + 1);  // initially, mytour column 1
-        d = norm(mygraph.node[start] - mygraph.node[end]);
+        start = tour_node(key, perm, c);    // initially, mytour column 0
+        end = tour_node(key, perm, c + 1);  // initially, mytour column 1
+        d = mygraph->get_cost(COST_LENGTH, start, end);
         dtot = dtot + d;
     }
     obj[0] = dtot;
@@ -130,7 +184,7 @@ void test_problem (double *xreal, double *xbin, int **gene, double *obj, double
 
 // Two objectives: the horizontal and vertical components of the total tour length.
 #ifdef wsp2
-void test_problem (double *xreal, double *xbin, int **gene, double *obj, double *constr)
+void test_problem (double *xreal, double *xbin, int **gene, int *perm, double *obj, double *constr)
 {
     /*
      * Add up the length of the Hamiltonian path, going in the order
@@ -139,17 +193,15 @@ void test_problem (double *xreal, double *xbin, int **gene, double *obj, double
     int start, end; // each edge of the graph has a start node and an end node.
     double x, xtot; // horizontal component of edge weight (distance) and total path distance.
     double y, ytot; // vertical component edge weight (distance) and total path distance.
-    Vec3 edge;
     x = y = xtot = ytot = 0.0;
     int key;        // the corresponding row number in mytour.
-    key = (int)xreal[0];  // convert double to int.
-    for (int c = 0; c < mytour.cols - 1; c++) // always start at node #0
-    {
-        start = mytour.get_target(key, c);    // initially, mytour column 0
-        end = mytour.get_target(key, c + 1);  // initially, mytour column 1
-        edge = mygraph.node[start] - mygraph.node[end];
-        x = fabs(edge.getX());
-        y = fabs(edge.getY());
+    key = (nperm != 0) ? 0 : (int)xreal[0];  // convert double to int.
+    for (int c = 0; c < targets; c++) // always start at node #0
+    {
+        start = tour_node(key, perm, c);    // initially, mytour column 0
+        end = tour_node(key, perm, c + 1);  // initially, mytour column 1
+        x = mygraph->get_cost(COST_X, start, end);
+        y = mygraph->get_cost(COST_Y, start, end);
         xtot = xtot + x;
         ytot = ytot + y;
     }
@@ -160,7 +212,167 @@ void test_problem (double *xreal, double *xbin, int **gene, double *obj, double
 #endif // wsp2
 
 #ifdef wsp_astro
-void test_problem (double *xreal, double *xbin, int **gene, double *obj, double *constr)
+/**
+ * Decode the times of a wsp_astro tour.  See wsp_astro_eval() for the
+ * chromosome structure.
+ * @param xreal the real variables.
+ * @param g index of the first dwell gene.
+ * @param n number of legs.
+ * @param dwell gets how long the chaser waits with each target.
+ * @param TOF gets the time of flight of each leg.
+ * @param t_depart gets the departure time of each leg.
+ * @param t_arrive gets the arrival time of each leg.
+ */
+static inline void
+tour_times (const double *xreal, int g, int n, double *dwell, double *TOF,
+            double *t_depart, double *t_arrive)
+{
+    for (int i = 0; i < n; i++)
+    {
+        dwell[i] = xreal[2 * i + g];
+        TOF[i] = xreal[2 * i + g + 1];
+    }
+
+    t_depart[0] = dwell[0];
+    t_arrive[0] = dwell[0] + TOF[0];
+    for (int i = 1; i < n; i++)
+    {
+        t_depart[i] = t_depart[i - 1] + TOF[i - 1] + dwell[i];
+        t_arrive[i] = t_arrive[i - 1] + dwell[i] + TOF[i];
+    }
+}
+
+/**
+ * Can the rest of a tour be skipped?  True if a lower bound on its
+ * delta-V already proves it violates the delta-V constraint, or it is
+ * dominated by a member of bound_front, the current feasible first front.
+ * Delta-V only grows as legs are added, so neither can be undone.
+ * @param t the tour's total time (minutes), known before any legs.
+ * @param dv delta-V of the legs priced so far (m/s).
+ */
+static bool
+tour_pruned (double t, double dv)
+{
+    if (4.0 * dv > t)  // same test as constr[0].
+        return true;
+
+    for (int k = 0; k < front_size; k++)
+    {
+        double ft = bound_front[2 * k];
+        double fdv = bound_front[2 * k + 1];
+        if ((ft <= t) && (fdv <= dv) && ((ft < t) || (fdv < dv)))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Price one leg of a wsp_astro tour: propagate the targets to the ends of
+ * the leg and find the best transfer between them.
+ * @param xfer the Lambert solver strategy.
+ * @param start node the leg starts from.
+ * @param end node the leg ends at.
+ * @param t_depart departure time.
+ * @param t_arrive arrival time.
+ * @param tof time of flight.
+ * @param t_total time of the whole tour, for pruning.
+ * @param dv_so_far delta-V of the legs before this one, for pruning.
+ * @param dv gets the leg's delta-V (ER/TU), or its bound if LEG_HOPELESS.
+ */
+template <class Solver> static leg_status
+price_leg (Solver& xfer, int start, int end, double t_depart, double t_arrive,
+           double tof, double t_total, double dv_so_far, double& dv)
+{
+    Vec3 V_start, V_end, R_start, R_end;
+    TrajState start_traj, end_traj;
+
+    // mycon->t10s[start] is the target at the beginning of this edge.
+    // t_depart is the time at which we leave upon this transfer arc.
+    // And so, start_traj is the state of the chaser at time t_depart prior
+    // to the first burn.
+    STAT_INC(STAT_KEPLER_CALLS);
+    try
+    {
+        start_traj = propagate(mycon->t10s[start], t_depart);
+    }
+    catch (int e)
+    {
+        // The caller marks the entire tour as dirty and abandons it.
+        STAT_INC(1 == e ? STAT_KEPLER_LIMIT : STAT_KEPLER_FG);
+        cerr << "Kepler 1 ";
+        if (1 == e) cerr << "failed to converge." << endl;
+        if (2 == e) cerr << "was out of tolerance." << endl;
+        return LEG_KEPLER_FAILED;
+    }
+
+    // mycon->t10s[end] is the target at the end of this edge.
+    // t_arrive is the time of intercept.
+    // end_traj is the state of the intercepted target at time t_arrive.
+    STAT_INC(STAT_KEPLER_CALLS);
+    try
+    {
+        end_traj = propagate(mycon->t10s[end], t_arrive);
+    }
+    catch (int e)
+    {
+        // The caller marks the entire tour as dirty and abandons it.
+        STAT_INC(1 == e ? STAT_KEPLER_LIMIT : STAT_KEPLER_FG);
+        cerr << "Kepler 1 ";
+        if (1 == e) cerr << "failed to converge." << endl;
+        if (2 == e) cerr << "was out of tolerance." << endl;
+        return LEG_KEPLER_FAILED;
+    }
+
+    // Extract initial preburn state vector from start_traj.
+    R_start = start_traj.r;
+    V_start = start_traj.v;
+
+    // Extract final post-rndz state vector from end_traj.
+    R_end = end_traj.r;
+    V_end = end_traj.v;
+
+    // With prune on, don't even try a leg whose delta-V bound alone
+    // would get the tour pruned.  The bound stands in for its delta-V.
+    if (prune)
+    {
+        dv = dv_bound(R_start, V_start, R_end, V_end);
+        if (tour_pruned(t_total * TU_MIN, (dv_so_far + dv) * ERTU))
+            return LEG_HOPELESS;
+    }
+
+    // Note: you *may* create more than one solver object if you want.
+    // TODO (maybe?): enforce singleton solver.
+    dv = best_transfer(xfer, R_start, V_start, R_end, V_end, tof).dv;
+    return LEG_PRICED;
+}
+
+/**
+ * Per-thread scratch space for the evaluator's times, when there are too
+ * many targets for the stack.  It only ever grows, so once it is big
+ * enough evaluation doesn't touch the heap.
+ * @param size how many doubles are needed.
+ */
+static double *
+eval_scratch (int size)
+{
+    static thread_local vector<double> scratch;
+
+    if ((int)scratch.size() < size)
+        scratch.resize(size);
+
+    return &scratch[0];
+}
+
+/**
+ * The wsp_astro evaluator, compiled once per Lambert solver strategy and
+ * target count.  With N targets known at compile time the times live on
+ * the stack and the leg loops have a fixed trip count; N = 0 is the
+ * fallback for any other number of targets.  test_problem() below picks
+ * the instance.
+ */
+template <class Solver, int N> static void
+wsp_astro_eval (double *xreal, int *perm, double *obj, double *constr)
 {
     /* CHROMOSOME STRUCTURE:
      * xreal[0] = key  (the tour order)
@@ -172,6 +384,10 @@ void test_problem (double *xreal, double *xbin, int **gene, double *obj, double
      * xreal[6] = TOF2
      * etc...
      *
+     * With a permutation chromosome, perm[] is the tour order (less the
+     * chaser, node 0) and there is no key: dwell0 is xreal[0], TOF0 is
+     * xreal[1], and so on.
+     *
      * obj[0] = total time of flight
      * obj[1] = total delta-V
      *
@@ -181,17 +397,24 @@ void test_problem (double *xreal, double *xbin, int **gene, double *obj, double
     obj[0] = 0.0;
     obj[1] = 0.0;
     int start, end; // each edge of the graph has a start node and an end node.
-    int key = (int)xreal[0];  // convert double to int.
-    int rev_limit;
-    Vec3 V_start, V_end, R_start, R_end;
-    double dv_long, dv_short, dv_best;  // longway and shortway deltaV's
-    Traj start_traj, end_traj;
-    ULambert xfer;
+    int key = (nperm != 0) ? 0 : (int)xreal[0];  // convert double to int.
+    int g = (nperm != 0) ? 0 : 1;  // index of the first dwell gene.
+    Solver xfer;
+    leg_status status;  // what became of each leg.
+    double dv;          // delta-V of each leg.
+    int prefix = 0;     // the tour so far, a node of leg_trie.
+    int node;           // this leg, a node of leg_trie.
     bool x_clean, t_clean;
-    double* dwell    = new double [TARGETS];
-    double* TOF      = new double [TARGETS];
-    double* t_depart = new double [TARGETS];
-    double* t_arrive = new double [TARGETS];
+    const int n = (N > 0) ? N : targets;  // legs of the tour.
+    double fixed[4 * ((N > 0) ? N : 1)];  // the times, if N is known.
+    double *dwell = fixed;
+
+    if (0 == N)
+        dwell = eval_scratch(4 * n);
+
+    double *TOF      = dwell + n;
+    double *t_depart = TOF + n;
+    double *t_arrive = t_depart + n;
 
     // The tour starts out clean and becomes dirty if any legs of the tour
     // fail completely.
@@ -200,150 +423,68 @@ void test_problem (double *xreal, double *xbin, int **gene, double *obj, double
     // dwell and TOF are intermediate variables to make this easier to comprehend.
     // Dwell is how long the chaser waits while rndz'd with each target.
     // TOF is the time of flight (duh).
-    for (int i = 0; i < TARGETS; i++)
-    {
-        dwell[i] = xreal[2 * i + 1];
-        TOF[i] = xreal[2 * i + 2];
-    }
+    tour_times(xreal, g, n, dwell, TOF, t_depart, t_arrive);
 
-    t_depart[0] = dwell[0];
-    t_arrive[0] = dwell[0] + TOF[0];
-    for (int i = 1; i < TARGETS; i++)
+    for (int c = 0; c < n; c++)
     {
-        t_depart[i] = t_depart[i - 1] + TOF[i - 1] + dwell[i];
-        t_arrive[i] = t_arrive[i - 1] + dwell[i] + TOF[i];
-    }
-
-    for (int c = 0; c < TARGETS; c++)
-    {
-        // Each leg of the tour is assumed to be impossible until at least one
-        // successful transfer is found.
-        x_clean = false;
+        start = tour_node(key, perm, c);   // Beginning point for this edge.
+        end = tour_node(key, perm, c + 1); // End point for this edge.
 
-        start = mytour.get_target(key, c);   // Beginning point for this edge.
-        end = mytour.get_target(key, c + 1); // End point for this edge.
-
-        // mycon.t10s[start] is the target at the beginning of this edge (the c-th edge)
-        // t_depart[c] is the time at which we leave upon the c-th transfer arc.
-        // And so, start_traj is the state of the chaser at time t_depart[c] prior
-        // to the first burn.
-        try
+        // Each distinct tour prefix is only priced once per population;
+        // node is this leg's place in leg_trie, under prefix.
+        node = (NULL != leg_trie) ? leg_trie->find(prefix, end, dwell[c], TOF[c]) : -1;
+        if (node >= 0)
         {
-            start_traj = kepler(mycon.t10s[start], t_depart[c]);
+            STAT_INC(STAT_LEGS_SHARED);
+            status = leg_trie->get_status(node);
+            dv = leg_trie->get_dv(node);
         }
-        catch (int e)
+        else
         {
-            // Mark the entire tour as dirty and abandon it.
-            cerr << "Kepler 1 ";
-            if (1 == e) cerr << "failed to converge." << endl;
-            if (2 == e) cerr << "was out of tolerance." << endl;
-            t_clean = false;
-            break;
+            status = price_leg(xfer, start, end, t_depart[c], t_arrive[c], TOF[c],
+                               t_arrive[n-1], obj[1], dv);
+            // A hopeless leg's bound depends on the rest of the tour.
+            if ((NULL != leg_trie) && (LEG_HOPELESS != status))
+                node = leg_trie->insert(prefix, end, dwell[c], TOF[c], status, dv);
         }
+        prefix = node;
 
-        // mycon.t10s[end] is the target at the end of this edge.
-        // t_arrive[c] is the time of intercept.
-        // end_traj is the state of the intercepted target at time t_arrive[c].
-        try
-        {
-            end_traj = kepler(mycon.t10s[end], t_arrive[c]);
-        }
-        catch (int e)
+        if (LEG_KEPLER_FAILED == status)
         {
             // Mark the entire tour as dirty and abandon it.
-            cerr << "Kepler 1 ";
-            if (1 == e) cerr << "failed to converge." << endl;
-            if (2 == e) cerr << "was out of tolerance." << endl;
             t_clean = false;
             break;
         }
 
-        // Extract initial preburn state vector from start_traj.
-        R_start = start_traj.get_r();
-        V_start = start_traj.get_v();
-
-        // Extract final post-rndz state vector from end_traj.
-        R_end = end_traj.get_r();
-        V_end = end_traj.get_v();
-
-        // Note: you *may* create more than one ULambert object if you want.
-        // TODO (maybe?): enforce singleton ULambert.
-        // Set up the universal Lambert problem.
-        xfer.setRo(R_start);
-        xfer.setR(R_end);
-        xfer.sett(TOF[c]);
-
-        /*
-         * Lambert's problem has FOUR solutions:
-         * 1. prograde, short-way
-         * 2. prograde, long-way
-         * 3. retrograde, short-way
-         * 4. retrograde, long-way
-         *
-         * The retrograde solutions are a huge delta-V penalty.
-         * So we just look at the long-way and short-way prograde transfers
-         * and pick whichever is best.
-         * 
-         * foo.universal(false, n ) means SHORT WAY, n revs.
-         * foo.universal(true, n )  means LONG WAY, n revs.
-         */
-    
-        dv_best = INF; // dv_best stores the best delta-V of all the attempts.
-        // Look for single and multi-rev solutions.
-        // Don't bother trying more revs than is possible for the given TOF.
-        rev_limit = 1 + 2 * (int)(TOF[c] / M_PI);
-        //cout << rev_limit << endl;
-        for (int revs = 0; revs < rev_limit; revs++) // multirev kludge
-        //for (int revs = 0; revs < 600; revs++) // multirev kludge
+        if (LEG_HOPELESS == status)
         {
-            dv_short = INF;
-            dv_long = INF;
-            xfer.universal(false, revs);  // short-way
-            // if ULambert didn't fail to converge, and it didn't hit the Earth
-            if (   ! (xfer.isFailure())
-                && ! (hit_Earth(R_start, R_end, xfer.getVo(), xfer.getV())))
-            {
-                dv_short = norm(xfer.getVo() - V_start)
-                           + norm(xfer.getV() - V_end);
-            }
-
-            xfer.universal(true, revs);  // long-way
-            if (   ! (xfer.isFailure())
-                && ! (hit_Earth(R_start, R_end, xfer.getVo(), xfer.getV())))
-            {
-                dv_long = norm(xfer.getVo() - V_start)
-                          + norm(xfer.getV() - V_end);
-            }
+            obj[1] = obj[1] + dv;
+            eval_pruned = 1;
+            STAT_INC(STAT_PRUNED);
+            break;
+        }
 
-            if (dv_short < dv_best)
-            {
-                dv_best = dv_short;
-                x_clean = true;  // Found at least 1 good xfer.
-            }
+        // Each leg of the tour is impossible unless at least one
+        // successful transfer was found.
+        x_clean = (dv < INF);
+        obj[1] = obj[1] + dv;
+        if ( ! x_clean ) t_clean = false; // any failed leg causes a failed tour.
 
-            if (dv_long < dv_best)
-            {
-                dv_best = dv_long;
-                x_clean = true; // Found at least 1 good xfer.
-            }
+        // With prune on, give up on a tour as soon as it is known to be
+        // infeasible or dominated.  It keeps the delta-V of the legs priced
+        // so far, a lower bound, which still ranks it behind the tours that
+        // pruned it.
+        if (prune && (c < n - 1)
+            && ( ! t_clean || tour_pruned(t_arrive[n-1] * TU_MIN, obj[1] * ERTU)))
+        {
+            eval_pruned = 1;
+            STAT_INC(STAT_PRUNED);
+            break;
         }
-        // XXX we don't track which solution (long/short, #revs) was best.
-        obj[1] = obj[1] + dv_best;
-        if ( ! x_clean ) t_clean = false; // any failed leg causes a failed tour.
     } // End doing Lambert problems for each leg of the tour.
 
     // The time-of-flight objective function is quite simple.
-    obj[0] = t_arrive[TARGETS-1];
-
-    /* CLEAN UP MEMORY */
-    delete dwell;
-    delete TOF;
-    delete t_depart;
-    delete t_arrive;
-    dwell    = NULL;
-    TOF      = NULL;
-    t_depart = NULL;
-    t_arrive = NULL;
+    obj[0] = t_arrive[n-1];
 
     obj[0] *= TU_MIN; // convert from TU to minutes.
     obj[1] *= ERTU;   // convert from ER/TU to m/s.
@@ -351,21 +492,299 @@ void test_problem (double *xreal, double *xbin, int **gene, double *obj, double
     // We don't want "Star Trek" style maneuvers, so we will
     // constrain missions that use an obscene amount of delta-V.
     // A negative constraint value means a violation.
+    // A pruned tour only has a bound on its delta-V, so it can't be shown
+    // feasible.  It was dominated by the feasible front, or infeasible.
     //if (obj[1] > 1000)  // the cutoff is arbitrary
-    if (4.0 * obj[1] > obj[0])  // this seems to work better.
+    if (eval_pruned)
         constr[0] = -1.0; // constrained.
+    else if (4.0 * obj[1] > obj[0])  // this seems to work better.
+    {
+        constr[0] = -1.0; // constrained.
+        STAT_INC(STAT_CONSTR_DV);
+    }
     else
         constr[0] = 1.0;  // not constrained.
 
     // There are 2 types of constraint, in the hopes that NSGA-II
     // might discern between them and be more effective.
     if ( ! t_clean )
+    {
         constr[1] = -1.0; // constrained.
+        STAT_INC(STAT_CONSTR_FAILED);
+    }
     else
         constr[1] = 1.0;  // not constrained.
 
     return ;// Returning from a void function, just to annoy Brian.
 }
+
+/**
+ * Pick the wsp_astro evaluator for the run's target count.
+ */
+template <class Solver> static void
+wsp_astro_targets (double *xreal, int *perm, double *obj, double *constr)
+{
+    switch (targets)
+    {
+        case 2: wsp_astro_eval<Solver, 2>(xreal, perm, obj, constr); break;
+        case 3: wsp_astro_eval<Solver, 3>(xreal, perm, obj, constr); break;
+        case 4: wsp_astro_eval<Solver, 4>(xreal, perm, obj, constr); break;
+        case 5: wsp_astro_eval<Solver, 5>(xreal, perm, obj, constr); break;
+        case 6: wsp_astro_eval<Solver, 6>(xreal, perm, obj, constr); break;
+        case 7: wsp_astro_eval<Solver, 7>(xreal, perm, obj, constr); break;
+        case 8: wsp_astro_eval<Solver, 8>(xreal, perm, obj, constr); break;
+        default: wsp_astro_eval<Solver, 0>(xreal, perm, obj, constr); break;
+    }
+}
+
+void test_problem (double *xreal, double *xbin, int **gene, int *perm, double *obj, double *constr)
+{
+    switch (leg_method)
+    {
+        case LAMBERT_BATTIN:
+            wsp_astro_targets<BattinSolver>(xreal, perm, obj, constr);
+            break;
+        default:
+            wsp_astro_targets<UniversalSolver>(xreal, perm, obj, constr);
+            break;
+    }
+}
+
+/**
+ * Re-fly every leg of the final front under J2 (and drag, if drag_coeff
+ * is set) with RK78, the way the chaser would really fly it: each target
+ * is integrated from epoch to the leg's ends, the chaser leaves the
+ * departure target's true state with the planned first burn, and the
+ * leg reports how far the chaser misses the arrival target and what the
+ * second burn really costs.  All target arcs go to RK78 in one batch,
+ * then all chaser arcs in another.
+ * @param pop the final population; only its first front is checked.  That
+ * is the feasible front, if any tour is feasible.
+ * @param fpt gets one line per leg.
+ * @param fpt_params gets a summary.
+ */
+template <class Solver> static void
+validate_front (population *pop, FILE *fpt, FILE *fpt_params)
+{
+    Solver xfer;
+    RK78 truth(RK78_TOL, drag_coeff);
+    vector<int> who, leg, from, to;  // individual, leg and nodes of each leg
+    vector<double> t_start, tof, dv_plan, dv2_plan;
+    vector<Vec3> burn;               // planned first burn of each leg
+    vector<Vec3> r, v, rc, vc;       // targets' then chaser's states
+    vector<double> t, tc;
+    vector<double> dwell(targets), TOF(targets), t_depart(targets), t_arrive(targets);
+    double miss, worst = 0.0;
+    int g = (nperm != 0) ? 0 : 1;
+
+    for (int i = 0; i < popsize; i++)
+    {
+        individual *ind = &pop->ind[i];
+        int key = (nperm != 0) ? 0 : (int)ind->xreal[0];
+
+        if (ind->rank != 1)
+            continue;
+
+        tour_times(ind->xreal, g, targets, &dwell[0], &TOF[0], &t_depart[0], &t_arrive[0]);
+        for (int c = 0; c < targets; c++)
+        {
+            int start = tour_node(key, ind->perm, c);
+            int end = tour_node(key, ind->perm, c + 1);
+            TrajState start_traj, end_traj;
+            Transfer best;
+
+            try
+            {
+                start_traj = propagate(mycon->t10s[start], t_depart[c]);
+                end_traj = propagate(mycon->t10s[end], t_arrive[c]);
+            }
+            catch (int e)
+            {
+                continue;
+            }
+
+            best = best_transfer(xfer, start_traj.r, start_traj.v,
+                                 end_traj.r, end_traj.v, TOF[c]);
+            if (best.dv >= INF)
+                continue;
+
+            xfer.solve(best.longway, best.revs);
+            who.push_back(i);
+            leg.push_back(c);
+            from.push_back(start);
+            to.push_back(end);
+            t_start.push_back(t_depart[c]);
+            tof.push_back(TOF[c]);
+            dv_plan.push_back(best.dv);
+            dv2_plan.push_back(norm(end_traj.v - xfer.getV()));
+            burn.push_back(xfer.getVo() - start_traj.v);
+
+            r.push_back(mycon->t10s[start].get_r());
+            v.push_back(mycon->t10s[start].get_v());
+            t.push_back(t_depart[c]);
+            r.push_back(mycon->t10s[end].get_r());
+            v.push_back(mycon->t10s[end].get_v());
+            t.push_back(t_arrive[c]);
+        }
+    }
+
+    // The targets, from epoch.
+    truth.propagate(r, v, t);
+
+    // The chaser, from the departure target's true state.
+    for (size_t l = 0; l < who.size(); l++)
+    {
+        rc.push_back(r[2 * l]);
+        vc.push_back(v[2 * l] + burn[l]);
+        tc.push_back(tof[l]);
+    }
+
+    truth.propagate(rc, vc, tc);
+
+    fprintf(fpt, "# This file contains the final front's legs flown with RK78\n");
+    fprintf(fpt, "# individual, leg, from, to, departure (min), time of flight (min), planned delta-V (m/s), miss (km), planned second burn (m/s), second burn (m/s)\n");
+    for (size_t l = 0; l < who.size(); l++)
+    {
+        miss = norm(rc[l] - r[2 * l + 1]) * ER;
+        if (miss > worst)  // false for a failed (NaN) leg.
+            worst = miss;
+
+        fprintf(fpt, "%d\t%d\t%d\t%d\t%e\t%e\t%e\t%e\t%e\t%e\n",
+                who[l], leg[l], from[l], to[l], t_start[l] * TU_MIN, tof[l] * TU_MIN,
+                dv_plan[l] * ERTU, miss, dv2_plan[l] * ERTU,
+                norm(v[2 * l + 1] - vc[l]) * ERTU);
+    }
+
+    fprintf(fpt_params, "\n Number of front legs validated = %d", (int)who.size());
+    fprintf(fpt_params, "\n Worst miss distance of a validated leg = %e km", worst);
+    fprintf(fpt_params, "\n Number of RK78 steps = %ld, rejected = %ld, failed trajectories = %ld",
+            truth.steps, truth.rejects, truth.failures);
+}
+
+/**
+ * Validate the final front with the run's Lambert solver strategy.
+ */
+static void
+validate_pop (population *pop, FILE *fpt, FILE *fpt_params)
+{
+    switch (leg_method)
+    {
+        case LAMBERT_BATTIN:
+            validate_front<BattinSolver>(pop, fpt, fpt_params);
+            break;
+        default:
+            validate_front<UniversalSolver>(pop, fpt, fpt_params);
+            break;
+    }
+}
+
+/**
+ * Solve the problem exactly with every dwell and time of flight on a grid
+ * of exact_step, within the GA's own gene bounds, and compare the GA's
+ * feasible front with it.  The GA isn't held to the grid, so it can beat
+ * the exact front as well as fall short of it.
+ * @param pop the final population; only its first front is compared.
+ * @param fpt gets one line per exact front tour.
+ * @param fpt_params gets a summary.
+ */
+template <class Solver> static void
+exact_front (population *pop, FILE *fpt, FILE *fpt_params)
+{
+    vector<double> dwell_lo, dwell_hi, tof_lo, tof_hi;
+    int g = (nperm != 0) ? 0 : 1;
+    int beaten = 0, beats = 0, feasible = 0;
+    double start;
+
+    for (int c = 0; c < targets; c++)
+    {
+        dwell_lo.push_back(min_realvar[g + 2 * c]);
+        dwell_hi.push_back(max_realvar[g + 2 * c]);
+        tof_lo.push_back(min_realvar[g + 2 * c + 1]);
+        tof_hi.push_back(max_realvar[g + 2 * c + 1]);
+    }
+
+    start = wall_time();
+    TourBB<Solver> exact(*mycon, exact_step, dwell_lo, dwell_hi, tof_lo, tof_hi);
+    exact.solve(true);
+
+    fprintf(fpt, "# This file contains the exact front with times on a grid of %e TU\n", exact_step);
+    fprintf(fpt, "# time (min), delta-V (m/s), order, then dwell and time of flight (TU) of each leg\n");
+    for (size_t k = 0; k < exact.front.size(); k++)
+    {
+        BBTour& t = exact.front[k];
+
+        fprintf(fpt, "%e\t%e\t", t.t, t.dv);
+        for (size_t c = 0; c < t.order.size(); c++)
+            fprintf(fpt, "%d", t.order[c]);
+        for (size_t c = 0; c < t.dwell.size(); c++)
+            fprintf(fpt, "\t%e\t%e", t.dwell[c] * exact_step, t.tof[c] * exact_step);
+        fprintf(fpt, "\n");
+    }
+
+    // Who dominates whom, the GA's feasible front against the exact one.
+    for (int i = 0; i < popsize; i++)
+    {
+        individual *ind = &pop->ind[i];
+        bool lost = false;
+
+        if ((ind->rank != 1) || (ind->constr_violation < 0.0))
+            continue;
+
+        feasible++;
+        for (size_t k = 0; k < exact.front.size(); k++)
+        {
+            BBTour& t = exact.front[k];
+
+            if ((t.t <= ind->obj[0]) && (t.dv <= ind->obj[1]) &&
+                ((t.t < ind->obj[0]) || (t.dv < ind->obj[1])))
+                lost = true;
+        }
+        if (lost)
+            beaten++;
+    }
+
+    for (size_t k = 0; k < exact.front.size(); k++)
+    {
+        BBTour& t = exact.front[k];
+
+        for (int i = 0; i < popsize; i++)
+        {
+            individual *ind = &pop->ind[i];
+
+            if ((ind->rank == 1) && (ind->constr_violation >= 0.0) &&
+                (ind->obj[0] <= t.t) && (ind->obj[1] <= t.dv) &&
+                ((ind->obj[0] < t.t) || (ind->obj[1] < t.dv)))
+            {
+                beats++;
+                break;
+            }
+        }
+    }
+
+    fprintf(fpt_params, "\n Exact front grid step = %e TU, tours on the grid = %e", exact_step, exact.combos);
+    fprintf(fpt_params, "\n Exact front legs priced = %lld, partial tours = %lld, complete tours = %lld",
+            exact.legs_priced, exact.nodes, exact.tours);
+    fprintf(fpt_params, "\n Exact front size = %d, found in %e s", (int)exact.front.size(), wall_time() - start);
+    fprintf(fpt_params, "\n Feasible GA front points dominated by the exact front = %d of %d", beaten, feasible);
+    fprintf(fpt_params, "\n Exact front points dominated by the GA front = %d", beats);
+}
+
+/**
+ * Find the exact front with the run's Lambert solver strategy.
+ */
+static void
+exact_pop (population *pop, FILE *fpt, FILE *fpt_params)
+{
+    switch (leg_method)
+    {
+        case LAMBERT_BATTIN:
+            exact_front<BattinSolver>(pop, fpt, fpt_params);
+            break;
+        default:
+            exact_front<UniversalSolver>(pop, fpt, fpt_params);
+            break;
+    }
+}
 #endif // wsp_astro
 
 /****************************************************************/
@@ -373,10 +792,52 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
 {
     if (argc < 3)
     {
-        cout << "Usage ./orbgnosis [random_seed] [output_file_prefix]" << endl;
+        cout << "Usage ./orbgnosis [random_seed] [output_file_prefix] [lambert=universal|battin] [prune=on|off] [share=on|off] [memo=on|off] [quantum=q] [propagator=two-body|j2] [validate=on|off] [drag=B] [exact=h] [targets=N]" << endl;
         exit(1);
     }
 
+    // Optional arguments, after the seed and prefix.
+    for (int opt = 3; opt < argc; opt++)
+    {
+        if (strcmp(argv[opt], "lambert=universal") == 0)
+            leg_method = LAMBERT_UNIVERSAL;
+        else if (strcmp(argv[opt], "lambert=battin") == 0)
+            leg_method = LAMBERT_BATTIN;
+        else if (strcmp(argv[opt], "prune=on") == 0)
+            prune = 1;
+        else if (strcmp(argv[opt], "prune=off") == 0)
+            prune = 0;
+        else if (strcmp(argv[opt], "share=on") == 0)
+            share = 1;
+        else if (strcmp(argv[opt], "share=off") == 0)
+            share = 0;
+        else if (strcmp(argv[opt], "memo=on") == 0)
+            memo = 1;
+        else if (strcmp(argv[opt], "memo=off") == 0)
+            memo = 0;
+        else if (strncmp(argv[opt], "quantum=", 8) == 0 && atof(argv[opt] + 8) >= 0.0)
+            memo_quantum = atof(argv[opt] + 8);
+        else if (strcmp(argv[opt], "propagator=two-body") == 0)
+            target_propagator = PROPAGATE_TWO_BODY;
+        else if (strcmp(argv[opt], "propagator=j2") == 0)
+            target_propagator = PROPAGATE_SECULAR_J2;
+        else if (strcmp(argv[opt], "validate=on") == 0)
+            validate = 1;
+        else if (strcmp(argv[opt], "validate=off") == 0)
+            validate = 0;
+        else if (strncmp(argv[opt], "drag=", 5) == 0 && atof(argv[opt] + 5) >= 0.0)
+            drag_coeff = atof(argv[opt] + 5);
+        else if (strncmp(argv[opt], "exact=", 6) == 0 && atof(argv[opt] + 6) >= 0.0)
+            exact_step = atof(argv[opt] + 6);
+        else if (strncmp(argv[opt], "targets=", 8) == 0 && atoi(argv[opt] + 8) >= 1)
+            targets = atoi(argv[opt] + 8);
+        else
+        {
+            cout << "\nUnknown option " << argv[opt] << ", hence exiting\n";
+            exit(1);
+        }
+    }
+
     seed = (double)atof(argv[1]);
 
     if (seed <= 0.0 || seed >= 1.0)
@@ -386,6 +847,9 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
     }
     srand (seed * 2*RAND_MAX); // XXX probably bad on some weird arch
 
+    mygraph = new Graph(targets + 1);
+    mycon = new Constellation(targets + 1);
+
 
 
 	#ifdef wsp_astro
@@ -393,77 +857,61 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
     // International Space Station
     //mytraj.set_elorb(1.05354259105, 0.0012287, 0.90124090184, 0.55411411224, 0.46170940032, 1.01);
 
-    // 3 sats in 1 planes, leader-follower spaced 100km, planes 0.5 deg apart
-    mycon.t10s[0].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 1.5708, 0.98);
-    mycon.t10s[1].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 2.5708, 1.0);
-    mycon.t10s[2].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 3.5708, 1.0156788020);
-    mycon.t10s[3].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 4.5708, 1.0313576039);
+    // 3 sats in 1 planes, leader-follower spaced 100km, planes 0.5 deg apart.
+    // Any more targets carry on down the line with the same spacing.
+    const double arg_p[4] = { 1.5708, 2.5708, 3.5708, 4.5708 };
+    const double anomaly[4] = { 0.98, 1.0, 1.0156788020, 1.0313576039 };
+    for (int k = 0; k <= targets; k++)
+    {
+        int last = (k < 4) ? k : 3;
+        mycon->t10s[k].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626,
+                                 arg_p[last] + (k - last),
+                                 anomaly[last] + (k - last) * 0.0156788020);
+    }
 
-    //mycon.t10s[0].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 1.0, 0.98);
-    //mycon.t10s[1].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 2.0, 1.0);
-    //mycon.t10s[2].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 3.0, 1.0156788020);
-    //mycon.t10s[3].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 4.0, 1.0313576039);
+    //mycon->t10s[0].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 1.0, 0.98);
+    //mycon->t10s[1].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 2.0, 1.0);
+    //mycon->t10s[2].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 3.0, 1.0156788020);
+    //mycon->t10s[3].set_elorb(1.106, 0.0035, 1.4835298642, 0.872664626, 4.0, 1.0313576039);
 
     // 1 Plane of Globalstar, chaser starts co-planar and lower with same apogee height.
-    //mycon.t10s[0].set_elorb(1.200000, 0.018080, 0.907658, 5.759587, 2.002129, 1.745329);
-    //mycon.t10s[1].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 0.124533);
-    //mycon.t10s[2].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 1.221730);
-    //mycon.t10s[3].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 2.268928);
-    //mycon.t10s[4].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 3.316126);
-    //mycon.t10s[5].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 4.363323);
-    //mycon.t10s[6].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 5.410521);
+    //mycon->t10s[0].set_elorb(1.200000, 0.018080, 0.907658, 5.759587, 2.002129, 1.745329);
+    //mycon->t10s[1].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 0.124533);
+    //mycon->t10s[2].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 1.221730);
+    //mycon->t10s[3].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 2.268928);
+    //mycon->t10s[4].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 3.316126);
+    //mycon->t10s[5].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 4.363323);
+    //mycon->t10s[6].set_elorb(1.221580, 0.000092, 0.907658, 5.759587, 2.002129, 5.410521);
 
 
-    //mycon.noise(0.001);
-    mycon.print();
+    //mycon->noise(0.001);
+    mycon->print();
     cout << endl;
 	#endif /* wsp_astro */
 
 
 	#ifdef wsp2 /*----------------------------------------------*/
 
-    mygraph.set_all(Vec3(100.0, 100.0, 0.0));
-    mygraph.noise(1.0);
+    mygraph->set_all(Vec3(100.0, 100.0, 0.0));
+    mygraph->noise(1.0);
 
     //mygraph.print();
     //cout << endl;
     //mytour.printOrder();
     //cout << endl;
-    // Do an exhaustive search and find the best wsp2, just to check.
-    int start, end;
-    Vec3 edge;
-    double x, xtot, y, ytot;
-    double xbest, ybest;
-    int key_xbest, key_ybest;
-    x = y = xtot = ytot = 0.0;
-    xbest = INF;
-    ybest = INF;
-    key_xbest = -999;
-    key_ybest = -999;
-    for (int r = 0; r < mytour.rows; r++)
-    {
-        xtot = 0.0;
-        ytot = 0.0;
-        for (int c = 0; c < mytour.cols - 1; c++) // always start at node #0
-        {
-            start = mytour.get_target(r, c);    // initially, mytour column 0
-            end   = mytour.get_target(r, c+1);  // initially, mytour column 1
-            edge = mygraph.node[start] - mygraph.node[end];
-            x = fabs(edge.getX());
-            y = fabs(edge.getY());
-            xtot = xtot + x;
-            ytot = ytot + y;
-        }
-        if (xtot < xbest)
-        {
-            xbest = xtot;
-            key_xbest = r;
-        }
-        if (ytot < ybest)
-        {
-            ybest = ytot;
-            key_ybest = r;
-        }
+    // Find the true front of wsp2, just to check.  Held-Karp can't take
+    // more than HELDKARP_MAXNODES nodes, and the check mustn't stop a run.
+    HeldKarp *truth = NULL;
+    if (targets + 1 <= HELDKARP_MAXNODES)
+    {
+        graph_cost wsp2_costs[2] = { COST_X, COST_Y };
+        truth = new HeldKarp(*mygraph, 2, wsp2_costs);
+        truth->solve();
+    }
+    else
+    {
+        cout << "Skipping the Held-Karp check, " << targets + 1
+        << " nodes is more than " << HELDKARP_MAXNODES << "." << endl;
     }
 	#endif /* wsp2 -----------------------------------------------*/
 
@@ -675,9 +1123,72 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
         }
     }
 
-    if (nreal == 0 && nbin == 0)
+    printf("\n Enter the length of the permutation variable (0 for none) : ");
+    scanf("%d", &nperm);
+
+    if (nperm != 0 && nperm != targets)
+    {
+        printf ("\n length of permutation entered is : %d", nperm);
+        printf ("\n The permutation must hold all %d targets, hence exiting \n", targets);
+        exit(1);
+    }
+
+    if (nperm != 0)
+    {
+        printf ("\n Enter the probability of crossover of the permutation (0.6-1.0) : ");
+        scanf ("%lf", &pcross_perm);
+
+        if (pcross_perm < 0.0 || pcross_perm > 1.0)
+        {
+            printf("\n Probability of crossover entered is : %e", pcross_perm);
+            printf("\n Entered value of probability of crossover of the permutation is out of bounds, hence exiting \n");
+            exit (1);
+        }
+
+        printf ("\n Enter the permutation crossover (0 for OX) (1 for PMX) : ");
+        scanf ("%d", &perm_cross_type);
+
+        if (perm_cross_type != 0 && perm_cross_type != 1)
+        {
+            printf("\n Entered the wrong permutation crossover, hence exiting \n");
+            exit (1);
+        }
+
+        printf ("\n Enter the probability of mutation of the permutation : ");
+        scanf ("%lf", &pmut_perm);
+
+        if (pmut_perm < 0.0 || pmut_perm > 1.0)
+        {
+            printf("\n Probability of mutation entered is : %e", pmut_perm);
+            printf("\n Entered value of probability of mutation of the permutation is out of bounds, hence exiting \n");
+            exit (1);
+        }
+    }
+
+    else
     {
-        printf("\n Number of real as well as binary variables, both are zero, hence exiting \n");
+        // Only a real-coded key needs the tour table.
+        mytour = new Tour(targets);
+
+        if ( ! mytour->loaded())
+        {
+            printf("\n There is no tour table for %d targets, a permutation is required, hence exiting \n", targets);
+            exit(1);
+        }
+    }
+
+    #ifdef wsp_astro
+    if (nreal != ((nperm != 0) ? 0 : 1) + 2 * targets)
+    {
+        printf("\n number of real variables entered is : %d", nreal);
+        printf("\n Each of %d targets needs a dwell and a time of flight, hence exiting \n", targets);
+        exit(1);
+    }
+    #endif /* wsp_astro */
+
+    if (nreal == 0 && nbin == 0 && nperm == 0)
+    {
+        printf("\n Number of real, binary and permutation variables are all zero, hence exiting \n");
         exit(1);
     }
 
@@ -811,6 +1322,7 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
     }
 
     printf("\n Input data successfully entered, now performing initialization \n");
+    fprintf(fpt5, "\n Number of targets = %d", targets);
     fprintf(fpt5, "\n Population size = %d", popsize);
     fprintf(fpt5, "\n Number of generations = %d", ngen);
     fprintf(fpt5, "\n Number of objective functions = %d", nobj);
@@ -846,7 +1358,27 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
         fprintf(fpt5, "\n Probability of mutation of binary variable = %e", pmut_bin);
     }
 
+    fprintf(fpt5, "\n Length of permutation variable = %d", nperm);
+
+    if (nperm != 0)
+    {
+        fprintf(fpt5, "\n Probability of crossover of permutation = %e", pcross_perm);
+        fprintf(fpt5, "\n Permutation crossover = %s", perm_cross_type ? "PMX" : "OX");
+        fprintf(fpt5, "\n Probability of mutation of permutation = %e", pmut_perm);
+    }
+
     fprintf(fpt5, "\n Seed for random number generator = %e", seed);
+    fprintf(fpt5, "\n Lambert solver = %s",
+            (LAMBERT_BATTIN == leg_method) ? BattinSolver::name()
+                                           : UniversalSolver::name());
+    fprintf(fpt5, "\n Prune hopeless tours = %s", prune ? "on" : "off");
+    fprintf(fpt5, "\n Share tour prefixes = %s", share ? "on" : "off");
+    fprintf(fpt5, "\n Memoize evaluations = %s, quantum = %e", memo ? "on" : "off", memo_quantum);
+    fprintf(fpt5, "\n Target propagator = %s",
+            (PROPAGATE_SECULAR_J2 == target_propagator) ? "secular J2" : "two-body");
+    fprintf(fpt5, "\n Validate final front = %s, drag Cd A / m = %e m^2/kg",
+            validate ? "on" : "off", drag_coeff);
+    fprintf(fpt5, "\n Exact discretized front step = %e TU", exact_step);
     bitlength = 0;
 
     if (nbin != 0)
@@ -857,26 +1389,46 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
         }
     }
 
-    fprintf(fpt1, "# of objectives = %d, # of constraints = %d, # of real_var = %d, # of bits of bin_var = %d, constr_violation, rank, crowding_distance\n", nobj, ncon, nreal, bitlength);
-    fprintf(fpt2, "# of objectives = %d, # of constraints = %d, # of real_var = %d, # of bits of bin_var = %d, constr_violation, rank, crowding_distance\n", nobj, ncon, nreal, bitlength);
-    fprintf(fpt3, "# of objectives = %d, # of constraints = %d, # of real_var = %d, # of bits of bin_var = %d, constr_violation, rank, crowding_distance\n", nobj, ncon, nreal, bitlength);
-    fprintf(fpt4, "# of objectives = %d, # of constraints = %d, # of real_var = %d, # of bits of bin_var = %d, constr_violation, rank, crowding_distance\n", nobj, ncon, nreal, bitlength);
+    fprintf(fpt1, "# of objectives = %d, # of constraints = %d, # of real_var = %d, # of bits of bin_var = %d, # of perm = %d, constr_violation, rank, crowding_distance\n", nobj, ncon, nreal, bitlength, nperm);
+    fprintf(fpt2, "# of objectives = %d, # of constraints = %d, # of real_var = %d, # of bits of bin_var = %d, # of perm = %d, constr_violation, rank, crowding_distance\n", nobj, ncon, nreal, bitlength, nperm);
+    fprintf(fpt3, "# of objectives = %d, # of constraints = %d, # of real_var = %d, # of bits of bin_var = %d, # of perm = %d, constr_violation, rank, crowding_distance\n", nobj, ncon, nreal, bitlength, nperm);
+    fprintf(fpt4, "# of objectives = %d, # of constraints = %d, # of real_var = %d, # of bits of bin_var = %d, # of perm = %d, constr_violation, rank, crowding_distance\n", nobj, ncon, nreal, bitlength, nperm);
     nbinmut = 0;
     nrealmut = 0;
     nbincross = 0;
     nrealcross = 0;
+    npermmut = 0;
+    npermcross = 0;
+    nuntouched = 0;
     parent_pop = (population *)malloc(sizeof(population));
     child_pop = (population *)malloc(sizeof(population));
     mixed_pop = (population *)malloc(sizeof(population));
     allocate_memory_pop (parent_pop, popsize);
     allocate_memory_pop (child_pop, popsize);
     allocate_memory_pop (mixed_pop, 2*popsize);
+    bound_front = (double *)malloc(2 * popsize * sizeof(double));
+    if (nperm != 0)
+    {
+        perm_work = (int *)malloc(nperm * sizeof(int));
+    }
+    if (share)
+    {
+        // Each evaluation adds at most one leg per target.
+        leg_trie = new LegTrie();
+        leg_trie->reserve(popsize * targets);
+    }
+    #ifdef wsp_astro
+    eval_scratch(4 * targets);  // warm this thread's scratch up front.
+    #endif /* wsp_astro */
+    if (memo) eval_memo = new EvalMemo(nreal, nbin, nbits, nperm, nobj, ncon, memo_quantum);
     randomize();
     initialize_pop (parent_pop);
     printf("\n Initialization done, now performing first generation");
-    decode_pop(parent_pop);
-    evaluate_pop (parent_pop);
-    assign_rank_and_crowding_distance (parent_pop);
+    STATS_OPEN(argv[2]);
+    STAT_PHASE(PHASE_DECODE, decode_pop(parent_pop));
+    STAT_PHASE(PHASE_EVALUATE, evaluate_pop (parent_pop));
+    STAT_PHASE(PHASE_SORT, assign_rank_and_crowding_distance (parent_pop));
+    STATS_RECORD(1);
     report_pop (parent_pop, fpt1);
     fprintf(fpt4, "# gen = 1\n");
     report_pop(parent_pop, fpt4);
@@ -896,12 +1448,14 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
 
     for (i = 2; i <= ngen; i++)
     {
-        selection (parent_pop, child_pop);
-        mutation_pop (child_pop);
-        decode_pop(child_pop);
-        evaluate_pop(child_pop);
-        merge (parent_pop, child_pop, mixed_pop);
-        fill_nondominated_sort (mixed_pop, parent_pop);
+        STAT_PHASE(PHASE_SELECTION, selection (parent_pop, child_pop));
+        STAT_PHASE(PHASE_MUTATION, mutation_pop (child_pop));
+        STAT_PHASE(PHASE_DECODE, decode_pop(child_pop));
+        if (prune) set_front_bound (parent_pop);
+        STAT_PHASE(PHASE_EVALUATE, evaluate_pop(child_pop));
+        STAT_PHASE(PHASE_MERGE, merge (parent_pop, child_pop, mixed_pop));
+        STAT_PHASE(PHASE_SORT, fill_nondominated_sort (mixed_pop, parent_pop));
+        STATS_RECORD(i);
 
         //fprintf(fpt4, "# gen = %d\n", i);
         //report_pop(parent_pop, fpt4);
@@ -920,6 +1474,34 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
     report_pop(parent_pop, fpt2);
     report_feasible(parent_pop, fpt3);
 
+    #ifdef wsp_astro
+    if (validate)
+    {
+        char validate_name[80];
+        FILE *fpt6;
+
+        printf("\n Validating the final front");
+        fflush(stdout);
+        sprintf(validate_name, "%s_validate.out", argv[2]);
+        fpt6 = fopen(validate_name, "w");
+        validate_pop(parent_pop, fpt6, fpt5);
+        fclose(fpt6);
+    }
+
+    if (exact_step > 0.0)
+    {
+        char exact_name[80];
+        FILE *fpt7;
+
+        printf("\n Finding the exact front on a grid of %e TU", exact_step);
+        fflush(stdout);
+        sprintf(exact_name, "%s_exact.out", argv[2]);
+        fpt7 = fopen(exact_name, "w");
+        exact_pop(parent_pop, fpt7, fpt5);
+        fclose(fpt7);
+    }
+    #endif /* wsp_astro */
+
     if (nreal != 0)
     {
         fprintf(fpt5, "\n Number of crossover of real variable = %d", nrealcross);
@@ -932,6 +1514,25 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
         fprintf(fpt5, "\n Number of mutation of binary variable = %d", nbinmut);
     }
 
+    if (nperm != 0)
+    {
+        fprintf(fpt5, "\n Number of crossover of permutation = %d", npermcross);
+        fprintf(fpt5, "\n Number of mutation of permutation = %d", npermmut);
+    }
+
+    if (NULL != leg_trie)
+    {
+        fprintf(fpt5, "\n Number of legs priced = %ld", leg_trie->priced);
+        fprintf(fpt5, "\n Number of legs shared = %ld", leg_trie->shared);
+    }
+
+    if (NULL != eval_memo)
+    {
+        fprintf(fpt5, "\n Number of chromosomes memoized = %ld", eval_memo->size());
+        fprintf(fpt5, "\n Number of evaluations copied from the memo = %ld", eval_memo->hits);
+        fprintf(fpt5, "\n Number of children not evaluated (untouched) = %d", nuntouched);
+    }
+
     fflush(stdout);
     fflush(fpt1);
     fflush(fpt2);
@@ -943,6 +1544,7 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
     fclose(fpt3);
     fclose(fpt4);
     fclose(fpt5);
+    long eval_allocs = STATS_CLOSE();
 
     if (choice != 0)
     {
@@ -968,15 +1570,43 @@ int main (int argc, char **argv) // arg is a random seed {0...1}
     free (parent_pop);
     free (child_pop);
     free (mixed_pop);
+    free (bound_front);
+    if (nperm != 0)
+    {
+        free (perm_work);
+    }
+    if (NULL != leg_trie)
+    {
+        delete leg_trie;
+        leg_trie = NULL;
+    }
+    if (NULL != eval_memo)
+    {
+        delete eval_memo;
+        eval_memo = NULL;
+    }
+    delete mytour;
+    delete mygraph;
+    delete mycon;
     printf("\n Routine successfully exited \n");
 
-    /*
-        cout << "The shortest horizontal tour was # " << key_xbest << ", length = ";
-        cout << xbest << endl;
-        cout << "The shortest vertical tour was # " << key_ybest << ", length = ";
-        cout << ybest << endl;
-    */
+#ifdef wsp2
+    if (NULL != truth)
+    {
+        cout << "Held-Karp found " << truth->front.size()
+        << " nondominated tours." << endl;
+        cout << "The shortest horizontal tour was " << truth->front.front().obj[0] << endl;
+        cout << "The shortest vertical tour was " << truth->front.back().obj[1] << endl;
+        delete truth;
+    }
+#endif
 
+    if (eval_allocs > 0)
+    {
+        cerr << "ERROR: test_problem allocated " << eval_allocs
+             << " times.  Evaluation must not touch the heap." << endl;
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
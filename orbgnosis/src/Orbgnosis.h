@@ -38,7 +38,9 @@
 #include "Graph.h"
 #include "Tour.h"
 
-#define TARGETS 3
+#define DEFAULT_TARGETS 3  //!< targets per tour unless told otherwise.
+
+extern int targets;         //!< targets per tour, chaser not included.
 
 #define INF 1.0e14    //!< A very big number
 #define SMALL 1.0e-8   //!< Tolerance and general-purpose "really small number"
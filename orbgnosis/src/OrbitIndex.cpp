@@ -0,0 +1,334 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include "Catalog.h"
+#include "Kepler.h"
+#include "OrbitIndex.h"
+#include "Orbgnosis.h"
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Wrap an angle into [0, 2 pi).
+ */
+static inline double
+wrap ( double x )
+{
+    x = fmod( x, 2.0 * M_PI );
+    return ( x < 0.0 ) ? x + 2.0 * M_PI : x;
+}
+
+/**
+ * Wrap an angle difference into [-pi, pi).
+ */
+static inline double
+wrap_difference ( double x )
+{
+    return wrap( x + M_PI ) - M_PI;
+}
+
+/**
+ * OrbitIndex constructor.  Indexes every object in the catalog, at epoch
+ * zero.  A cell a few degrees on a side suits LEO catalogs.
+ * @param catin the objects.
+ * @param nraanin number of cells around the equator.
+ * @param ninclin number of cells from 0 to pi inclination.
+ */
+OrbitIndex::OrbitIndex ( const Catalog& catin, int nraanin, int ninclin ) :
+        cat( catin ),
+        nraan( nraanin ),
+        nincl( ninclin ),
+        epoch( 0.0 )
+{
+    int n = cat.size();
+    bool j2 = ( PROPAGATE_SECULAR_J2 == target_propagator );
+
+    if ( ( nraan < 1 ) || ( nincl < 1 ) )
+    {
+        cerr << "ERROR: OrbitIndex needs at least one cell each way." << endl;
+        exit( 1 );
+    }
+
+    cells.resize( nraan * nincl );
+    cell.resize( n );
+    slot.resize( n );
+    node.resize( n );
+    u.resize( n );
+    sin_i.resize( n );
+    u_0.resize( n );
+    u_dot.resize( n );
+    node_dot.resize( n );
+
+    for ( int k = 0; k < n; k++ )
+    {
+        bool closed = ( cat.e[ k ] < 1.0 );
+
+        node[ k ] = wrap( cat.raan[ k ] );
+        sin_i[ k ] = sin( cat.i[ k ] );
+        u_0[ k ] = closed ? cat.w[ k ] + cat.M[ k ] : cat.w[ k ] + cat.f[ k ];
+        u[ k ] = wrap( u_0[ k ] );
+        u_dot[ k ] = closed ? ( j2 ? cat.w_dot[ k ] + cat.M_dot[ k ] : cat.n[ k ] ) : 0.0;
+        node_dot[ k ] = j2 ? cat.raan_dot[ k ] : 0.0;
+
+        insert( k, incl_cell( cat.i[ k ] ) * nraan + raan_cell( node[ k ] ) );
+    }
+}
+
+/**
+ * OrbitIndex destructor.
+ */
+OrbitIndex::~OrbitIndex ( void )
+{
+}
+
+/**
+ * The raan column of an angle in [0, 2 pi).
+ */
+int
+OrbitIndex::raan_cell ( double x ) const
+{
+    int c = ( int )( x * nraan / ( 2.0 * M_PI ) );
+    return ( c < nraan ) ? c : nraan - 1;
+}
+
+/**
+ * The inclination row of an inclination.
+ */
+int
+OrbitIndex::incl_cell ( double x ) const
+{
+    int c = ( int )( x * nincl / M_PI );
+    return ( c < 0 ) ? 0 : ( ( c < nincl ) ? c : nincl - 1 );
+}
+
+/**
+ * Put object k at the end of cell c.
+ */
+void
+OrbitIndex::insert ( int k, int c )
+{
+    cell[ k ] = c;
+    slot[ k ] = ( int ) cells[ c ].size();
+    cells[ c ].push_back( k );
+}
+
+/**
+ * Move the index to a new epoch: drift every node and phase, and move the
+ * objects whose node has left its cell.  Each move is a swap with the
+ * last object of the old cell, so it costs the same however full the
+ * cells are.
+ * @param t the new epoch (TU), measured from the catalog's epoch zero.
+ * @return how many objects changed cells.
+ */
+int
+OrbitIndex::advance ( double t )
+{
+    int n = ( int ) node.size();
+    int moved = 0;
+
+    for ( int k = 0; k < n; k++ )
+    {
+        node[ k ] = wrap( cat.raan[ k ] + node_dot[ k ] * t );
+        u[ k ] = wrap( u_0[ k ] + u_dot[ k ] * t );
+
+        int c = ( cell[ k ] / nraan ) * nraan + raan_cell( node[ k ] );
+
+        if ( c == cell[ k ] )
+            continue;
+
+        vector<int>& old = cells[ cell[ k ] ];
+        int last = old.back();
+
+        old[ slot[ k ] ] = last;
+        slot[ last ] = slot[ k ];
+        old.pop_back();
+
+        insert( k, c );
+        moved++;
+    }
+
+    epoch = t;
+    return moved;
+}
+
+/**
+ * Epoch of the nodes and phases (TU).
+ */
+double
+OrbitIndex::get_epoch ( void ) const
+{
+    return epoch;
+}
+
+/**
+ * Candidate neighbors of object k: every other object whose plane is
+ * within max_angle of k's and whose argument of latitude is within
+ * max_phase of k's, at the index's epoch.
+ * @param k the object.
+ * @param max_angle largest angle between the planes (radians).
+ * @param max_phase largest difference in argument of latitude (radians),
+ * pi or more for any phase.  Open orbits pass any phase check.
+ * @param out gets the candidates, in no particular order.
+ * @return the number of objects looked at, for comparing with a scan.
+ */
+int
+OrbitIndex::query ( int k, double max_angle, double max_phase,
+                    vector<int>& out ) const
+{
+    int looked = query( cat.i[ k ], node[ k ],
+                        ( cat.e[ k ] < 1.0 ) ? u[ k ] : NAN,
+                        max_angle, max_phase, out );
+
+    for ( size_t j = 0; j < out.size(); j++ )
+        if ( out[ j ] == k )
+        {
+            out[ j ] = out.back();
+            out.pop_back();
+            break;
+        }
+
+    return looked;
+}
+
+/**
+ * Candidate neighbors of any plane and phase.  The angle theta between
+ * two planes satisfies
+ *
+ *   sin^2(theta/2) = sin^2(di/2) + sin(i1) sin(i2) sin^2(draan/2),
+ *
+ * so within an inclination row, whose smallest sin(i2) is at one of its
+ * edges, draan is bounded, and only the raan columns within that bound
+ * are looked at.  Near the poles of the grid the bound is the whole row.
+ * @param incl inclination of the plane.
+ * @param raan its raan at the index's epoch.
+ * @param argLat argument of latitude at the epoch, NaN for any.
+ * @param max_angle largest angle between the planes (radians).
+ * @param max_phase largest difference in argument of latitude (radians).
+ * @param out gets the candidates, in no particular order.
+ * @return the number of objects looked at.
+ */
+int
+OrbitIndex::query ( double incl, double raan, double argLat,
+                    double max_angle, double max_phase,
+                    vector<int>& out ) const
+{
+    double s_max = sin( 0.5 * max_angle );
+    double si = sin( incl );
+    double di = M_PI / nincl;
+    int row_lo = incl_cell( incl - max_angle );
+    int row_hi = incl_cell( incl + max_angle );
+    int looked = 0;
+
+    s_max *= s_max;
+    raan = wrap( raan );
+    out.clear();
+
+    for ( int row = row_lo; row <= row_hi; row++ )
+    {
+        double sin_lo = min( sin( row * di ), sin( ( row + 1 ) * di ) );
+        double bound = ( si * sin_lo > 0.0 ) ? s_max / ( si * sin_lo ) : 2.0;
+        int col_lo = 0, ncols = nraan;
+
+        if ( bound < 1.0 )
+        {
+            double dr = 2.0 * asin( sqrt( bound ) );
+            col_lo = raan_cell( wrap( raan - dr ) );
+            ncols = raan_cell( wrap( raan + dr ) ) - col_lo + 1;
+
+            if ( ncols <= 0 )
+                ncols += nraan;
+
+            if ( 2.0 * dr >= 2.0 * M_PI - 2.0 * M_PI / nraan )
+            {
+                col_lo = 0;
+                ncols = nraan;
+            }
+        }
+
+        for ( int c = 0; c < ncols; c++ )
+        {
+            const vector<int>& bucket = cells[ row * nraan + ( col_lo + c ) % nraan ];
+            looked += ( int ) bucket.size();
+
+            for ( size_t b = 0; b < bucket.size(); b++ )
+            {
+                int j = bucket[ b ];
+                double sdi = sin( 0.5 * ( cat.i[ j ] - incl ) );
+                double sdr = sin( 0.5 * ( node[ j ] - raan ) );
+
+                if ( sdi * sdi + si * sin_i[ j ] * sdr * sdr > s_max )
+                    continue;
+
+                if ( ( max_phase < M_PI ) && ( cat.e[ j ] < 1.0 ) && ! isnan( argLat )
+                        && ( fabs( wrap_difference( u[ j ] - argLat ) ) > max_phase ) )
+                    continue;
+
+                out.push_back( j );
+            }
+        }
+    }
+
+    return looked;
+}
+
+/**
+ * Angle between the planes of objects j and k at the index's epoch.
+ */
+double
+OrbitIndex::plane_angle ( int j, int k ) const
+{
+    double sdi = sin( 0.5 * ( cat.i[ j ] - cat.i[ k ] ) );
+    double sdr = sin( 0.5 * ( node[ j ] - node[ k ] ) );
+    double s = sdi * sdi + sin_i[ j ] * sin_i[ k ] * sdr * sdr;
+
+    return 2.0 * asin( sqrt( min( 1.0, s ) ) );
+}
+
+/**
+ * Raan of object k at the index's epoch.
+ */
+double
+OrbitIndex::get_raan ( int k ) const
+{
+    return node[ k ];
+}
+
+/**
+ * Mean argument of latitude of object k at the index's epoch.
+ */
+double
+OrbitIndex::get_argLat ( int k ) const
+{
+    return u[ k ];
+}
@@ -0,0 +1,114 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * An index of a Catalog's orbits by plane, for reachable-target queries.
+ */
+
+#ifndef _ORBITINDEX_H_
+#define _ORBITINDEX_H_
+#include "Catalog.h"
+#include <vector>
+
+using namespace std;
+
+/**
+ * Changing planes is what makes most of a catalog unreachable: the
+ * delta-V is about the orbital speed times the angle between the planes,
+ * so a few degrees cost more than any amount of phasing.  OrbitIndex
+ * buckets a Catalog's objects on a grid of raan and inclination, and
+ * answers "which objects are within so many degrees of this plane, and
+ * within so much argument of latitude of this phase" by visiting only
+ * the grid cells that can hold an answer, then checking those objects
+ * exactly.
+ *
+ * The node drifts under J2, so advance() moves the index to a new epoch.
+ * Inclination doesn't drift, and nodes move only a fraction of a degree a
+ * day, so most objects stay in their cell and only the ones which cross
+ * into a neighbor are moved.  Argument of latitude goes all the way round
+ * every orbit, so it isn't a grid key; it is worked out from its rate and
+ * checked per candidate.
+ *
+ * Rates follow target_propagator: secular J2 rates, or none but the mean
+ * motion for two-body.  The catalog must outlive the index, and mustn't
+ * grow while it is in use.
+ */
+class OrbitIndex
+{
+
+    public:
+        OrbitIndex ( const Catalog&,    // objects to index, at epoch zero
+                     int,               // raan cells
+                     int );             // inclination cells
+
+        virtual ~OrbitIndex ( void );
+
+        int advance ( double );     // returns how many objects moved
+        double get_epoch ( void ) const;
+
+        // Objects within max_angle of object k's plane and max_phase of its
+        // argument of latitude, k excluded.
+        int query ( int, double, double, vector<int>& ) const;
+
+        // The same, for any plane and phase.
+        int query ( double,         // inclination
+                    double,         // raan at the index's epoch
+                    double,         // argument of latitude at the epoch
+                    double,         // max_angle
+                    double,         // max_phase
+                    vector<int>& ) const;
+
+        double plane_angle ( int, int ) const;
+        double get_raan ( int ) const;
+        double get_argLat ( int ) const;
+
+    private:
+        int raan_cell ( double ) const;
+        int incl_cell ( double ) const;
+        void insert ( int, int );
+
+        const Catalog& cat;         //!< the indexed objects.
+        int nraan;                  //!< raan cells, round the equator.
+        int nincl;                  //!< inclination cells, 0 to pi.
+        double epoch;               //!< epoch of node and phase (TU).
+
+        vector< vector<int> > cells;    //!< objects in each cell.
+        vector<int> cell;           //!< each object's cell.
+        vector<int> slot;           //!< where it is in its cell.
+
+        vector<double> node;        //!< raan at the epoch.
+        vector<double> u;           //!< argument of latitude at the epoch.
+        vector<double> sin_i;       //!< sine of inclination.
+        vector<double> u_0;         //!< mean argument of latitude at zero.
+        vector<double> u_dot;       //!< its rate (radians/TU).
+        vector<double> node_dot;    //!< raan rate (radians/TU).
+};
+
+#endif /* _ORBITINDEX_H_ */
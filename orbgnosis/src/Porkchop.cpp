@@ -0,0 +1,285 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include "Kepler.h"
+#include "Orbgnosis.h"
+#include "Porkchop.h"
+#include "Traj.h"
+#include "Transfer.h"
+#include "LambertSolver.h"
+#include "Vec3.h"
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Porkchop constructor.
+ * @param fromin the departure target at epoch (t = 0).
+ * @param toin the arrival target at epoch.
+ */
+Porkchop::Porkchop ( Traj fromin, Traj toin ) :
+        nt( 0 ),
+        ntof( 0 ),
+        from( fromin ),
+        to( toin ),
+        t0( 0.0 ),
+        dt( 0.0 ),
+        tof0( 0.0 ),
+        dtof( 0.0 ),
+        cells( 0 )
+{
+}
+
+/**
+ * Porkchop destructor.
+ */
+Porkchop::~Porkchop ( void )
+{
+}
+
+/**
+ * Define the grid.  Times are canonical, measured from epoch.
+ * @param t0in first departure time, >= 0.
+ * @param t1in last departure time.
+ * @param ntin number of departure times, >= 1.
+ * @param tof0in shortest time of flight, > 0.
+ * @param tof1in longest time of flight.
+ * @param ntofin number of times of flight, >= 1.
+ */
+void
+Porkchop::set_grid ( double t0in, double t1in, int ntin,
+                     double tof0in, double tof1in, int ntofin )
+{
+    if ( ( ntin < 1 ) || ( ntofin < 1 ) || ( t0in < 0.0 ) || ( tof0in <= 0.0 )
+            || ( t1in < t0in ) || ( tof1in < tof0in ) )
+    {
+        cerr << "ERROR: Porkchop::set_grid was given a bad grid." << endl;
+        exit( 1 );
+    }
+
+    nt = ntin;
+    ntof = ntofin;
+    t0 = t0in;
+    tof0 = tof0in;
+    dt = ( nt > 1 ) ? ( t1in - t0in ) / ( nt - 1 ) : 0.0;
+    dtof = ( ntof > 1 ) ? ( tof1in - tof0in ) / ( ntof - 1 ) : 0.0;
+    cells.clear();
+}
+
+/**
+ * Price every cell of the grid.  Rows are independent, so they are shared
+ * out among threads, each with its own Lambert solver.
+ */
+void
+Porkchop::sweep ( void )
+{
+    cells.resize( nt * ntof );
+
+    #pragma omp parallel
+    {
+        UniversalSolver xfer;  // one solver per thread.
+
+        xfer.warm = true;
+
+        #pragma omp for schedule(dynamic)
+        for ( int r = 0; r < nt; r++ )
+            sweep_row( r, xfer );
+    }
+}
+
+/**
+ * Propagate a trajectory with the run's propagator, skipping it for (near)
+ * zero time.
+ */
+static TrajState
+advance ( Traj& traj_0, double t )
+{
+    if ( t <= SMALL )
+        return traj_state( traj_0, t );
+
+    return propagate( traj_0, t );
+}
+
+/**
+ * Price one row (departure time) of the grid.  The departure state is
+ * the same for the whole row.  Each arrival state is propagated from its
+ * neighbor's, one time of flight step earlier, which is a much shorter
+ * propagation than starting over from epoch; every PORKCHOP_ANCHOR
+ * columns it is propagated from epoch again, so errors can't pile up
+ * along the row.  Each Lambert solve is seeded with the neighbor's.
+ */
+void
+Porkchop::sweep_row ( int r, UniversalSolver& xfer )
+{
+    double t = get_t( r );
+    Transfer* row = &cells[ r * ntof ];
+    Transfer none;
+    TrajState start_traj, end_traj;
+    bool warm = false;  // is end_traj the previous column's arrival state?
+
+    xfer.cool();
+
+    none.dv = INF;
+    none.revs = 0;
+    none.longway = false;
+
+    try
+    {
+        start_traj = advance( from, t );
+    }
+    catch ( int e )
+    {
+        for ( int c = 0; c < ntof; c++ )
+            row[ c ] = none;
+
+        return;
+    }
+
+    for ( int c = 0; c < ntof; c++ )
+    {
+        try
+        {
+            // Warm starts are two-body only; J2 targets go from epoch.
+            if ( ! warm || ( 0 == c % PORKCHOP_ANCHOR )
+                    || ( PROPAGATE_TWO_BODY != target_propagator ) )
+                end_traj = advance( to, t + get_tof( c ) );
+            else if ( dtof > SMALL )
+                end_traj = kepler_state( end_traj, dtof );
+
+            warm = true;
+        }
+        catch ( int e )
+        {
+            // Start over from epoch at the next column.
+            warm = false;
+            row[ c ] = none;
+            continue;
+        }
+
+        row[ c ] = best_transfer( xfer, start_traj.r, start_traj.v,
+                                  end_traj.r, end_traj.v,
+                                  get_tof( c ) );
+    }
+}
+
+/**
+ * Departure time of row r.
+ */
+double
+Porkchop::get_t ( int r )
+{
+    return t0 + r * dt;
+}
+
+/**
+ * Time of flight of column c.
+ */
+double
+Porkchop::get_tof ( int c )
+{
+    return tof0 + c * dtof;
+}
+
+/**
+ * The best transfer of cell (r, c).  Its dv is INF if there wasn't one.
+ */
+Transfer
+Porkchop::get_cell ( int r, int c )
+{
+    return cells[ r * ntof + c ];
+}
+
+/**
+ * Write the grid in the compact binary format (see porkchop_header).
+ * Returns false if the file couldn't be written.
+ * @param filename the file to create.
+ */
+bool
+Porkchop::write ( const char* filename )
+{
+    porkchop_header h;
+    vector<float> dv( nt * ntof );
+    FILE* fpt = fopen( filename, "wb" );
+
+    if ( NULL == fpt )
+        return false;
+
+    memset( &h, 0, sizeof( h ) );
+    memcpy( h.magic, PORKCHOP_MAGIC, 4 );
+    h.version = PORKCHOP_VERSION;
+    h.nt = nt;
+    h.ntof = ntof;
+    h.t0 = t0;
+    h.dt = dt;
+    h.tof0 = tof0;
+    h.dtof = dtof;
+
+    for ( int k = 0; k < nt * ntof; k++ )
+        dv[ k ] = ( cells[ k ].dv < INF ) ? (float)( cells[ k ].dv * ERTU ) : -1.0f;
+
+    bool ok = ( 1 == fwrite( &h, sizeof( h ), 1, fpt ) )
+              && ( dv.size() == fwrite( &dv[ 0 ], sizeof( float ), dv.size(), fpt ) );
+
+    return ( 0 == fclose( fpt ) ) && ok;
+}
+
+/**
+ * Write the grid as text, one cell per line, with the best transfer's
+ * revolutions and direction as well.
+ * Returns false if the file couldn't be written.
+ * @param filename the file to create.
+ */
+bool
+Porkchop::write_csv ( const char* filename )
+{
+    FILE* fpt = fopen( filename, "w" );
+
+    if ( NULL == fpt )
+        return false;
+
+    fprintf( fpt, "# t_depart (TU), tof (TU), delta-V (m/s, -1 for none), revs, longway\n" );
+
+    for ( int r = 0; r < nt; r++ )
+    {
+        for ( int c = 0; c < ntof; c++ )
+        {
+            Transfer x = cells[ r * ntof + c ];
+            fprintf( fpt, "%e,%e,%e,%d,%d\n", get_t( r ), get_tof( c ),
+                     ( x.dv < INF ) ? x.dv * ERTU : -1.0,
+                     x.revs, x.longway ? 1 : 0 );
+        }
+    }
+
+    return 0 == fclose( fpt );
+}
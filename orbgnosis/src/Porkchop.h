@@ -0,0 +1,110 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#ifndef _PORKCHOP_H_
+#define _PORKCHOP_H_
+#include <stdint.h>
+#include <vector>
+#include "Traj.h"
+#include "Transfer.h"
+
+using namespace std;
+
+#define PORKCHOP_MAGIC   "OPKC"  //!< first four bytes of a porkchop grid file
+#define PORKCHOP_VERSION 1       //!< bump this if the layout ever changes
+#define PORKCHOP_ANCHOR  8       //!< columns between propagations from epoch
+
+/**
+ * Porkchop grid file header.  The header is followed by nt * ntof floats,
+ * the delta-V (m/s) of each (departure time, time of flight) cell, one
+ * departure time per row.  Cells without a feasible transfer hold -1.
+ * Fields are in native byte order.
+ */
+typedef struct
+{
+    char     magic[4];   //!< PORKCHOP_MAGIC, not null terminated
+    uint32_t version;    //!< PORKCHOP_VERSION
+    uint32_t nt;         //!< number of departure times (rows)
+    uint32_t ntof;       //!< number of times of flight (columns)
+    double   t0;         //!< first departure time (TU)
+    double   dt;         //!< departure time step (TU)
+    double   tof0;       //!< first time of flight (TU)
+    double   dtof;       //!< time of flight step (TU)
+}
+
+porkchop_header;
+
+/**
+ * The delta-V landscape of one ordered pair of targets.
+ * A Porkchop sweeps a grid of departure times and times of flight,
+ * pricing each cell with the same kepler() + best_transfer() logic
+ * as the wsp_astro problem.  Departure times are spread across threads, and
+ * along each row the arrival state is propagated from its neighbor's, and
+ * the Lambert solver seeded with its neighbor's solution.
+ */
+class Porkchop
+{
+
+    public:
+        Porkchop ( Traj,    // departure target at epoch
+                   Traj );  // arrival target at epoch
+
+        virtual ~Porkchop ( void );
+
+        // Define the grid: first and last value, and number of values,
+        // of departure time and of time of flight (canonical units).
+        void set_grid ( double, double, int, double, double, int );
+
+        void sweep ( void );   // Prices every cell of the grid.
+
+        // Accessors, valid after sweep().
+        double get_t ( int );          // departure time of row r
+        double get_tof ( int );        // time of flight of column c
+        Transfer get_cell ( int, int );  // best transfer of cell (r, c)
+
+        bool write ( const char* );      // binary grid file
+        bool write_csv ( const char* );  // the same, as text
+
+        int nt;     //!< number of departure times (rows)
+        int ntof;   //!< number of times of flight (columns)
+
+    private:
+        void sweep_row ( int, UniversalSolver& );
+
+        Traj from;      //!< departure target at epoch.
+        Traj to;        //!< arrival target at epoch.
+        double t0;      //!< first departure time.
+        double dt;      //!< departure time step.
+        double tof0;    //!< first time of flight.
+        double dtof;    //!< time of flight step.
+        vector<Transfer> cells;  //!< nt * ntof results, row major.
+};
+
+#endif /* _PORKCHOP_H_ */
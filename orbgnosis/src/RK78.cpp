@@ -0,0 +1,357 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include "Vec3.h"
+#include "Orbgnosis.h"
+#include "RK78.h"
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+#define RK78_FIRST_STEP 0.05   //!< first step of a batch (TU).
+#define RK78_MAX_STEPS 1000000 //!< accepted plus rejected steps per batch.
+
+// A single exponential atmosphere, fit around 400 km (Vallado table 8-4).
+#define RHO_0 3.725e-12        //!< density at H_0 (kg/m^3)
+#define H_0 400.0              //!< base altitude (km)
+#define H_SCALE 58.515         //!< scale height (km)
+#define OMEGA_EARTH 7.292115e-5  //!< Earth's rotation rate (rad/s)
+
+/*
+ * Fehlberg's 7(8) coefficients, from NASA TR R-287 (1968).  Thirteen
+ * stages; the eighth order solution is propagated and the difference from
+ * the seventh order one, 41/840 (k0 + k10 - k11 - k12), is the error.
+ */
+static const double c[ 13 ] =
+{
+    0.0, 2.0 / 27.0, 1.0 / 9.0, 1.0 / 6.0, 5.0 / 12.0, 0.5, 5.0 / 6.0,
+    1.0 / 6.0, 2.0 / 3.0, 1.0 / 3.0, 1.0, 0.0, 1.0
+};
+
+static const double a[ 13 ][ 12 ] =
+{
+    { 0 },
+    { 2.0 / 27.0 },
+    { 1.0 / 36.0, 1.0 / 12.0 },
+    { 1.0 / 24.0, 0.0, 1.0 / 8.0 },
+    { 5.0 / 12.0, 0.0, -25.0 / 16.0, 25.0 / 16.0 },
+    { 1.0 / 20.0, 0.0, 0.0, 1.0 / 4.0, 1.0 / 5.0 },
+    { -25.0 / 108.0, 0.0, 0.0, 125.0 / 108.0, -65.0 / 27.0, 125.0 / 54.0 },
+    { 31.0 / 300.0, 0.0, 0.0, 0.0, 61.0 / 225.0, -2.0 / 9.0, 13.0 / 900.0 },
+    { 2.0, 0.0, 0.0, -53.0 / 6.0, 704.0 / 45.0, -107.0 / 9.0, 67.0 / 90.0,
+      3.0 },
+    { -91.0 / 108.0, 0.0, 0.0, 23.0 / 108.0, -976.0 / 135.0, 311.0 / 54.0,
+      -19.0 / 60.0, 17.0 / 6.0, -1.0 / 12.0 },
+    { 2383.0 / 4100.0, 0.0, 0.0, -341.0 / 164.0, 4496.0 / 1025.0,
+      -301.0 / 82.0, 2133.0 / 4100.0, 45.0 / 82.0, 45.0 / 164.0,
+      18.0 / 41.0 },
+    { 3.0 / 205.0, 0.0, 0.0, 0.0, 0.0, -6.0 / 41.0, -3.0 / 205.0,
+      -3.0 / 41.0, 3.0 / 41.0, 6.0 / 41.0, 0.0 },
+    { -1777.0 / 4100.0, 0.0, 0.0, -341.0 / 164.0, 4496.0 / 1025.0,
+      -289.0 / 82.0, 2193.0 / 4100.0, 51.0 / 82.0, 33.0 / 164.0,
+      12.0 / 41.0, 0.0, 1.0 }
+};
+
+static const double b[ 13 ] =
+{
+    0.0, 0.0, 0.0, 0.0, 0.0, 34.0 / 105.0, 9.0 / 35.0, 9.0 / 35.0,
+    9.0 / 280.0, 9.0 / 280.0, 0.0, 41.0 / 840.0, 41.0 / 840.0
+};
+
+/**
+ * RK78 constructor.
+ * @param tolin the largest error allowed in one step, in any component of
+ * position (ER) or velocity (ER/TU).  1e-10 is about half a millimeter.
+ * @param dragin the ballistic coefficient Cd A / m (m^2/kg), or 0.0 for
+ * a J2-only force model.
+ */
+RK78::RK78 ( double tolin, double dragin ) :
+        steps( 0 ),
+        rejects( 0 ),
+        failures( 0 ),
+        tol( tolin ),
+        drag( dragin )
+{
+    if ( ( tol <= 0.0 ) || ( drag < 0.0 ) )
+    {
+        cerr << "ERROR: RK78 needs a positive tolerance and drag >= 0." << endl;
+        exit( 1 );
+    }
+}
+
+/**
+ * RK78 destructor.
+ */
+RK78::~RK78 ( void )
+{
+}
+
+/**
+ * The equations of motion of every lane, in scaled time: dy/dtau is the
+ * lane's end time T times dy/dt.  Two body gravity plus J2 and, if drag
+ * is on, an exponential atmosphere rotating with the Earth.
+ * @param y positions and velocities, canonical, one column per lane.
+ * @param T each lane's end time.
+ * @param dy gets dy/dtau.
+ */
+void
+RK78::derivs ( const double y[ 6 ][ RK78_LANES ], const double* T,
+               double dy[ 6 ][ RK78_LANES ] ) const
+{
+    // Canonical drag acceleration is -1/2 rho B (ER in m) |v| v, with
+    // rho in kg/m^3 and B in m^2/kg: the ER/TU^2 to m/s^2 factor cancels
+    // one of the ERTU^2 factors from v.
+    const double kdrag = 0.5 * drag * ER * 1000.0;
+    const double omega = OMEGA_EARTH * TU_SEC;
+
+    #pragma omp simd
+    for ( int l = 0; l < RK78_LANES; l++ )
+    {
+        double x = y[ 0 ][ l ], yy = y[ 1 ][ l ], z = y[ 2 ][ l ];
+        double r2 = x * x + yy * yy + z * z;
+        double r3 = r2 * sqrt( r2 );
+        double z2 = 5.0 * z * z / r2;
+        double j = 1.5 * J2 / r2;  // 3/2 J2 (R / r)^2, R = 1 ER
+
+        dy[ 0 ][ l ] = T[ l ] * y[ 3 ][ l ];
+        dy[ 1 ][ l ] = T[ l ] * y[ 4 ][ l ];
+        dy[ 2 ][ l ] = T[ l ] * y[ 5 ][ l ];
+        dy[ 3 ][ l ] = -T[ l ] * x / r3 * ( 1.0 + j * ( 1.0 - z2 ) );
+        dy[ 4 ][ l ] = -T[ l ] * yy / r3 * ( 1.0 + j * ( 1.0 - z2 ) );
+        dy[ 5 ][ l ] = -T[ l ] * z / r3 * ( 1.0 + j * ( 3.0 - z2 ) );
+    }
+
+    if ( 0.0 == drag )
+        return;
+
+    #pragma omp simd
+    for ( int l = 0; l < RK78_LANES; l++ )
+    {
+        double x = y[ 0 ][ l ], yy = y[ 1 ][ l ], z = y[ 2 ][ l ];
+        double r = sqrt( x * x + yy * yy + z * z );
+        double vx = y[ 3 ][ l ] + omega * yy;
+        double vy = y[ 4 ][ l ] - omega * x;
+        double vz = y[ 5 ][ l ];
+        double vrel = sqrt( vx * vx + vy * vy + vz * vz );
+        double rho = RHO_0 * exp( -( ( r - 1.0 ) * ER - H_0 ) / H_SCALE );
+        double f = T[ l ] * kdrag * rho * vrel;
+
+        dy[ 3 ][ l ] -= f * vx;
+        dy[ 4 ][ l ] -= f * vy;
+        dy[ 5 ][ l ] -= f * vz;
+    }
+}
+
+/**
+ * Integrate one batch of lanes from tau = 0 to 1, in lockstep.  A lane
+ * which falls inside the Earth is stopped there and marked failed, so
+ * it can't drag the step size of the others down to nothing.
+ * @param y positions and velocities, canonical, one column per lane;
+ * overwritten with the final states.
+ * @param T each lane's end time (TU); 0.0 leaves a lane where it is.
+ * Zeroed for failed lanes.
+ * @param failed gets true for each lane which crashed, or for every
+ * unfinished lane if the batch ran out of steps.
+ * @param nsteps gets the accepted steps added to it.
+ * @param nrejects gets the rejected steps added to it.
+ */
+void
+RK78::batch ( double y[ 6 ][ RK78_LANES ], double* T, bool* failed,
+              long& nsteps, long& nrejects ) const
+{
+    double k[ 13 ][ 6 ][ RK78_LANES ];  // stage derivatives
+    double ys[ 6 ][ RK78_LANES ];       // stage states
+    double tau = 0.0;
+    double h, err, Tmax = 0.0;
+    int tries = 0;
+
+    for ( int l = 0; l < RK78_LANES; l++ )
+    {
+        Tmax = max( Tmax, T[ l ] );
+        failed[ l ] = false;
+    }
+
+    if ( Tmax <= 0.0 )
+        return;
+
+    h = min( 1.0, RK78_FIRST_STEP / Tmax );
+
+    while ( tau < 1.0 )
+    {
+        if ( ++tries > RK78_MAX_STEPS )
+        {
+            for ( int l = 0; l < RK78_LANES; l++ )
+                failed[ l ] = failed[ l ] || ( T[ l ] > 0.0 );
+
+            return;
+        }
+
+        if ( tau + h > 1.0 )
+            h = 1.0 - tau;
+
+        derivs( y, T, k[ 0 ] );
+        for ( int s = 1; s < 13; s++ )
+        {
+            for ( int i = 0; i < 6; i++ )
+                for ( int l = 0; l < RK78_LANES; l++ )
+                    ys[ i ][ l ] = y[ i ][ l ];
+
+            for ( int m = 0; m < s; m++ )
+            {
+                if ( 0.0 == a[ s ][ m ] )
+                    continue;
+
+                for ( int i = 0; i < 6; i++ )
+                    for ( int l = 0; l < RK78_LANES; l++ )
+                        ys[ i ][ l ] += h * a[ s ][ m ] * k[ m ][ i ][ l ];
+            }
+
+            derivs( ys, T, k[ s ] );
+        }
+
+        // The worst error of any component of any lane.
+        err = 0.0;
+        for ( int i = 0; i < 6; i++ )
+            for ( int l = 0; l < RK78_LANES; l++ )
+                err = max( err, fabs( k[ 0 ][ i ][ l ] + k[ 10 ][ i ][ l ]
+                                      - k[ 11 ][ i ][ l ] - k[ 12 ][ i ][ l ] ) );
+        err *= h * 41.0 / 840.0;
+
+        if ( err <= tol )
+        {
+            for ( int s = 5; s < 13; s++ )
+            {
+                if ( 0.0 == b[ s ] )
+                    continue;
+
+                for ( int i = 0; i < 6; i++ )
+                    for ( int l = 0; l < RK78_LANES; l++ )
+                        y[ i ][ l ] += h * b[ s ] * k[ s ][ i ][ l ];
+            }
+
+            tau += h;
+            nsteps++;
+
+            for ( int l = 0; l < RK78_LANES; l++ )
+            {
+                if ( y[ 0 ][ l ] * y[ 0 ][ l ] + y[ 1 ][ l ] * y[ 1 ][ l ]
+                        + y[ 2 ][ l ] * y[ 2 ][ l ] < 1.0 )
+                {
+                    failed[ l ] = true;
+                    T[ l ] = 0.0;
+                }
+            }
+        }
+        else
+            nrejects++;
+
+        // The usual step size control for an 8th order error estimate,
+        // kept from swinging too far either way.
+        h *= ( err > 0.0 ) ? min( 4.0, max( 0.2, 0.9 * pow( tol / err, 0.125 ) ) ) : 4.0;
+    }
+}
+
+/**
+ * Propagate a set of states, each by its own time.  The states are sorted
+ * by time so that lanes of one batch end at about the same time, which
+ * keeps short lanes from riding along on the steps of long ones.
+ * Trajectories which crash into the Earth, or run out of steps, get NaN
+ * states and are counted in failures.
+ * @param r positions (ER) at t = 0, overwritten with positions at t.
+ * @param v velocities (ER/TU) at t = 0, overwritten with velocities at t.
+ * @param t time to propagate each state (TU), >= 0.
+ */
+void
+RK78::propagate ( vector<Vec3>& r, vector<Vec3>& v, const vector<double>& t )
+{
+    int n = (int) t.size();
+    int nbatch = ( n + RK78_LANES - 1 ) / RK78_LANES;
+    vector< pair<double, int> > order( n );
+    long nsteps = 0, nrejects = 0, nfailures = 0;
+
+    for ( int k = 0; k < n; k++ )
+        order[ k ] = make_pair( t[ k ], k );
+
+    sort( order.begin(), order.end() );
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:nsteps, nrejects, nfailures)
+    for ( int bt = 0; bt < nbatch; bt++ )
+    {
+        double y[ 6 ][ RK78_LANES ];
+        double T[ RK78_LANES ];
+        int lane[ RK78_LANES ];  // which state each lane holds
+        bool failed[ RK78_LANES ];
+
+        // A short last batch is padded with copies of its first state,
+        // going nowhere.
+        for ( int l = 0; l < RK78_LANES; l++ )
+        {
+            int o = bt * RK78_LANES + l;
+            lane[ l ] = ( o < n ) ? order[ o ].second : -1;
+            int k = ( o < n ) ? lane[ l ] : order[ bt * RK78_LANES ].second;
+            Vec3 rk = r[ k ], vk = v[ k ];
+
+            y[ 0 ][ l ] = rk.getX();
+            y[ 1 ][ l ] = rk.getY();
+            y[ 2 ][ l ] = rk.getZ();
+            y[ 3 ][ l ] = vk.getX();
+            y[ 4 ][ l ] = vk.getY();
+            y[ 5 ][ l ] = vk.getZ();
+            T[ l ] = ( o < n ) ? t[ k ] : 0.0;
+        }
+
+        batch( y, T, failed, nsteps, nrejects );
+
+        for ( int l = 0; l < RK78_LANES; l++ )
+        {
+            if ( lane[ l ] < 0 )
+                continue;
+
+            if ( failed[ l ] )
+            {
+                y[ 0 ][ l ] = y[ 1 ][ l ] = y[ 2 ][ l ] = NAN;
+                y[ 3 ][ l ] = y[ 4 ][ l ] = y[ 5 ][ l ] = NAN;
+                nfailures++;
+            }
+
+            r[ lane[ l ] ] = Vec3( y[ 0 ][ l ], y[ 1 ][ l ], y[ 2 ][ l ] );
+            v[ lane[ l ] ] = Vec3( y[ 3 ][ l ], y[ 4 ][ l ], y[ 5 ][ l ] );
+        }
+    }
+
+    steps += nsteps;
+    rejects += nrejects;
+    failures += nfailures;
+}
@@ -0,0 +1,82 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * A batched Runge-Kutta-Fehlberg 7(8) numerical propagator with J2 and,
+ * optionally, atmospheric drag.
+ */
+
+#ifndef _RK78_H_
+#define _RK78_H_
+#include <vector>
+#include "Vec3.h"
+
+using namespace std;
+
+#define RK78_LANES 8   //!< trajectories integrated in lockstep.
+
+/**
+ * A numerical propagator for checking answers, not for finding them: it
+ * is far too slow for the GA loop, but it is the truth kepler() and
+ * kepler_J2() are approximations of.
+ *
+ * Trajectories are integrated RK78_LANES at a time in lockstep.  Each
+ * lane's time runs from 0 to its own end time, scaled so every lane
+ * ends at tau = 1, and all lanes take the same steps in tau, sized for
+ * the least forgiving lane.  The lane loops are the innermost ones, so
+ * they vectorize.  Batches are spread across threads.
+ */
+class RK78
+{
+
+    public:
+        RK78 ( double,    // error tolerance per step (ER, ER/TU)
+               double );  // Cd A / m (m^2/kg), 0 for no drag
+
+        virtual ~RK78 ( void );
+
+        // Propagate each r[k], v[k] (canonical) forward by t[k] (TU), in place.
+        void propagate ( vector<Vec3>&, vector<Vec3>&, const vector<double>& );
+
+        long steps;     //!< accepted steps, summed over batches.
+        long rejects;   //!< rejected steps, summed over batches.
+        long failures;  //!< trajectories which crashed or ran out of steps.
+
+    private:
+        void batch ( double[ 6 ][ RK78_LANES ], double*, bool*,
+                     long&, long& ) const;
+        void derivs ( const double[ 6 ][ RK78_LANES ], const double*,
+                      double[ 6 ][ RK78_LANES ] ) const;
+
+        double tol;     //!< error tolerance per step.
+        double drag;    //!< Cd A / m (m^2/kg).
+};
+
+#endif /* _RK78_H_ */
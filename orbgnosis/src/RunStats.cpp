@@ -0,0 +1,222 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include "RunStats.h"
+
+#ifdef ORBGNOSIS_STATS
+
+#include "SolverStats.h"
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+
+using namespace std;
+
+long stat_count[ STAT_COUNTERS ];
+double stat_time[ STAT_PHASES ];
+__thread int stat_alloc_watch = 0;
+
+static FILE* stat_file = NULL;
+static char stat_prefix[ 1024 ];
+static SolverStats run_solver_stats;  //!< main thread's solver statistics.
+static long run_eval_allocs = 0;      //!< STAT_EVAL_ALLOCS over the run.
+
+static const char* stat_counter_names[ STAT_COUNTERS ] =
+    {
+        "evaluations", "memo_hits", "untouched", "infeasible", "kepler_calls", "kepler_limit", "kepler_fg",
+        "lambert_solves", "lambert_failures", "rev_branches", "bound_skips", "hit_earth",
+        "constr_dv", "constr_failed", "pruned",
+        "legs_shared", "eval_allocs"
+    };
+
+static const char* stat_phase_names[ STAT_PHASES ] =
+    {
+        "selection", "mutation", "decode", "evaluate", "merge", "sort"
+    };
+
+/**
+ * The global operator new, counting while STAT_WATCH_ALLOCS is watching.
+ * The array and nothrow forms, and every operator delete, come back here
+ * or to free(), so they all pair up.
+ */
+void*
+operator new ( size_t size )
+{
+    void* p;
+
+    if ( stat_alloc_watch > 0 )
+        STAT_INC( STAT_EVAL_ALLOCS );
+
+    p = malloc( size ? size : 1 );
+
+    if ( NULL == p )
+        throw bad_alloc();
+
+    return p;
+}
+
+void*
+operator new[] ( size_t size )
+{
+    return operator new( size );
+}
+
+void
+operator delete ( void* p ) throw ()
+{
+    free( p );
+}
+
+void
+operator delete[] ( void* p ) throw ()
+{
+    free( p );
+}
+
+void
+operator delete ( void* p, size_t ) throw ()
+{
+    free( p );
+}
+
+void
+operator delete[] ( void* p, size_t ) throw ()
+{
+    free( p );
+}
+
+/**
+ * Open the statistics file, PREFIX_stats.out, and write its header.
+ * Also start collecting solver statistics on this thread.
+ * @param prefix the output file prefix given on the command line.
+ */
+void
+stats_open ( const char* prefix )
+{
+    char name[ 1024 ];
+
+    snprintf( stat_prefix, sizeof( stat_prefix ), "%s", prefix );
+    snprintf( name, sizeof( name ), "%s_stats.out", prefix );
+    stat_file = fopen( name, "w" );
+
+    if ( NULL == stat_file )
+    {
+        cerr << "ERROR: could not write " << name << endl;
+        exit( 1 );
+    }
+
+    fprintf( stat_file, "# This file contains run statistics, one line per generation\n" );
+    fprintf( stat_file, "# Phase times are in seconds, counts are for that generation only\n" );
+    fprintf( stat_file, "# gen" );
+
+    for ( int p = 0; p < STAT_PHASES; p++ )
+        fprintf( stat_file, "\t%s", stat_phase_names[ p ] );
+
+    for ( int c = 0; c < STAT_COUNTERS; c++ )
+        fprintf( stat_file, "\t%s", stat_counter_names[ c ] );
+
+    fprintf( stat_file, "\n" );
+
+    for ( int p = 0; p < STAT_PHASES; p++ )
+        stat_time[ p ] = 0.0;
+
+    for ( int c = 0; c < STAT_COUNTERS; c++ )
+        stat_count[ c ] = 0;
+
+    run_solver_stats.clear();
+    SolverStats::attach( &run_solver_stats );
+}
+
+/**
+ * Write one generation's record, then start counting afresh.
+ * @param gen the generation number.
+ */
+void
+stats_record ( int gen )
+{
+    run_eval_allocs += stat_count[ STAT_EVAL_ALLOCS ];
+
+    if ( stat_count[ STAT_EVAL_ALLOCS ] > 0 )
+        cerr << "WARNING: test_problem allocated " << stat_count[ STAT_EVAL_ALLOCS ]
+             << " times in generation " << gen << endl;
+
+    fprintf( stat_file, "%d", gen );
+
+    for ( int p = 0; p < STAT_PHASES; p++ )
+    {
+        fprintf( stat_file, "\t%e", stat_time[ p ] );
+        stat_time[ p ] = 0.0;
+    }
+
+    for ( int c = 0; c < STAT_COUNTERS; c++ )
+    {
+        fprintf( stat_file, "\t%ld", stat_count[ c ] );
+        stat_count[ c ] = 0;
+    }
+
+    fprintf( stat_file, "\n" );
+    fflush( stat_file );
+}
+
+/**
+ * Close the statistics file, and write the whole run's solver
+ * statistics to PREFIX_solver_stats.out.
+ * @return heap allocations made inside test_problem over the whole run.
+ */
+long
+stats_close ( void )
+{
+    char name[ 1024 ];
+    FILE* fpt;
+
+    if ( NULL != stat_file )
+        fclose( stat_file );
+
+    stat_file = NULL;
+    SolverStats::attach( NULL );
+
+    snprintf( name, sizeof( name ), "%s_solver_stats.out", stat_prefix );
+    fpt = fopen( name, "w" );
+
+    if ( NULL == fpt )
+    {
+        cerr << "ERROR: could not write " << name << endl;
+        return run_eval_allocs;
+    }
+
+    fprintf( fpt, "# This file contains solver statistics for the whole run\n" );
+    fprintf( fpt, "solver,metric,value\n" );
+    run_solver_stats.write( fpt );
+    fclose( fpt );
+    return run_eval_allocs;
+}
+
+#endif /* ORBGNOSIS_STATS */
@@ -0,0 +1,133 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Run statistics: how long each phase of a generation takes, and how
+ * often the expensive or failure-prone things happen inside test_problem.
+ *
+ * Everything here compiles away to nothing unless ORBGNOSIS_STATS is
+ * defined (make BUILD_STATS=true).  When it is, the counters are bumped
+ * atomically, so they may be used from threads, and main() writes one
+ * record per generation to PREFIX_stats.out.  The main thread's
+ * SolverStats go to PREFIX_solver_stats.out at the end of the run.
+ *
+ * The stats build also replaces the global operator new, to count heap
+ * allocations made inside test_problem (STAT_WATCH_ALLOCS).  Evaluation
+ * is meant to be allocation free once it is warm, so any generation
+ * which allocates is reported on stderr, and the run exits non-zero
+ * ("make check_allocs").
+ */
+
+#ifndef _RUNSTATS_H_
+#define _RUNSTATS_H_
+
+/**
+ * Things to count.  Keep stat_counter_names[] in RunStats.cpp in step.
+ */
+enum stat_counter
+{
+    STAT_EVALUATIONS,       //!< calls to test_problem
+    STAT_MEMO_HITS,         //!< evaluations copied from eval_memo instead
+    STAT_UNTOUCHED,         //!< children identical to a parent, not evaluated
+    STAT_INFEASIBLE,        //!< ... which violated any constraint
+    STAT_KEPLER_CALLS,      //!< kepler() calls
+    STAT_KEPLER_LIMIT,      //!< kepler() threw 1, iteration limit
+    STAT_KEPLER_FG,         //!< kepler() threw 2, F&G out of tolerance
+    STAT_LAMBERT_SOLVES,    //!< Lambert solver calls
+    STAT_LAMBERT_FAILURES,  //!< ... which failed to converge
+    STAT_REV_BRANCHES,      //!< revolution counts tried in best_transfer
+    STAT_BOUND_SKIPS,       //!< legs where dv_bound() stopped the rest
+    STAT_HIT_EARTH,         //!< transfers rejected by hit_Earth()
+    STAT_CONSTR_DV,         //!< tours violating the delta-V constraint
+    STAT_CONSTR_FAILED,     //!< tours with a failed leg
+    STAT_PRUNED,            //!< tours abandoned early, see prune
+    STAT_LEGS_SHARED,       //!< legs found in leg_trie, not priced again
+    STAT_EVAL_ALLOCS,       //!< operator new calls inside test_problem
+    STAT_COUNTERS           //!< how many counters there are
+};
+
+/**
+ * Phases of a generation.  Keep stat_phase_names[] in step.
+ */
+enum stat_phase
+{
+    PHASE_SELECTION,
+    PHASE_MUTATION,
+    PHASE_DECODE,
+    PHASE_EVALUATE,
+    PHASE_MERGE,
+    PHASE_SORT,
+    STAT_PHASES             //!< how many phases there are
+};
+
+#ifdef ORBGNOSIS_STATS
+
+#include "Timer.h"
+
+extern long stat_count[ STAT_COUNTERS ];  //!< counts since the last record.
+extern double stat_time[ STAT_PHASES ];   //!< seconds since the last record.
+extern __thread int stat_alloc_watch;     //!< count this thread's allocations.
+
+void stats_open ( const char* );  // open PREFIX_stats.out
+void stats_record ( int );        // write one generation's record, and reset
+long stats_close ( void );        // returns test_problem's allocations
+
+#define STAT_INC( c ) ( (void)__sync_fetch_and_add( &stat_count[ c ], 1L ) )
+
+#define STAT_PHASE( p, statement )                   \
+    do {                                             \
+        double stat_phase_start = wall_time();       \
+        statement;                                   \
+        stat_time[ p ] += wall_time() - stat_phase_start; \
+    } while ( 0 )
+
+#define STAT_WATCH_ALLOCS( statement )              \
+    do {                                             \
+        stat_alloc_watch++;                          \
+        statement;                                   \
+        stat_alloc_watch--;                          \
+    } while ( 0 )
+
+#define STATS_OPEN( prefix ) stats_open( prefix )
+#define STATS_RECORD( gen ) stats_record( gen )
+#define STATS_CLOSE() stats_close()
+
+#else
+
+#define STAT_INC( c ) ( (void)0 )
+#define STAT_PHASE( p, statement ) do { statement; } while ( 0 )
+#define STAT_WATCH_ALLOCS( statement ) do { statement; } while ( 0 )
+#define STATS_OPEN( prefix ) ( (void)0 )
+#define STATS_RECORD( gen ) ( (void)0 )
+#define STATS_CLOSE() ( 0L )
+
+#endif /* ORBGNOSIS_STATS */
+
+#endif /* _RUNSTATS_H_ */
@@ -0,0 +1,186 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include "SolverStats.h"
+#include <stdio.h>
+#include <string.h>
+
+__thread SolverStats* solver_stats = NULL;
+
+static const char* regime_names[ REGIMES ] =
+    {
+        "elliptic", "parabolic", "hyperbolic"
+    };
+
+static const char* failure_names[ FAILURES ] =
+    {
+        "none", "iteration_limit", "y_negative", "180_degrees", "fg_tolerance"
+    };
+
+/**
+ * SolverStats constructor.  Everything starts at zero.
+ */
+SolverStats::SolverStats ( void )
+{
+    clear();
+}
+
+/**
+ * SolverStats destructor.  Detaches itself if it is still attached.
+ */
+SolverStats::~SolverStats ( void )
+{
+    if ( this == solver_stats )
+        solver_stats = NULL;
+}
+
+/**
+ * Set everything back to zero.
+ */
+void
+SolverStats::clear ( void )
+{
+    memset( &lambert, 0, sizeof( lambert ) );
+    memset( &kepler, 0, sizeof( kepler ) );
+}
+
+/**
+ * Add another thread's statistics to these.
+ */
+SolverStats&
+SolverStats::operator += ( const SolverStats& s )
+{
+    SolverTally* mine[] = { &lambert, &kepler };
+    const SolverTally* theirs[] = { &s.lambert, &s.kepler };
+
+    for ( int k = 0; k < 2; k++ )
+    {
+        for ( int r = 0; r < REGIMES; r++ )
+        {
+            mine[ k ]->calls[ r ] += theirs[ k ]->calls[ r ];
+            mine[ k ]->seconds[ r ] += theirs[ k ]->seconds[ r ];
+        }
+
+        for ( int f = 0; f < FAILURES; f++ )
+            mine[ k ]->failures[ f ] += theirs[ k ]->failures[ f ];
+
+        for ( int b = 0; b < SOLVER_STATS_BINS; b++ )
+            mine[ k ]->iterations[ b ] += theirs[ k ]->iterations[ b ];
+
+        mine[ k ]->corrections += theirs[ k ]->corrections;
+    }
+
+    return *this;
+}
+
+/**
+ * Attach statistics to the calling thread, or detach them with NULL.
+ */
+void
+SolverStats::attach ( SolverStats* s )
+{
+    solver_stats = s;
+}
+
+/**
+ * Record one call.
+ */
+void
+SolverStats::tally ( SolverTally& t, solver_regime regime, double seconds,
+                     int iterations, solver_failure why, int corrections )
+{
+    t.calls[ regime ]++;
+    t.seconds[ regime ] += seconds;
+    t.failures[ why ]++;
+    t.iterations[ ( iterations < SOLVER_STATS_BINS ) ? iterations : SOLVER_STATS_BINS - 1 ]++;
+    t.corrections += corrections;
+}
+
+/**
+ * Record one ULambert::universal() call.
+ * @param regime elliptic, parabolic or hyperbolic (by the final psi).
+ * @param seconds how long it took.
+ * @param iterations bisection loops.
+ * @param why why it failed, or FAIL_NONE.
+ * @param corrections times the Y-negative correction ran.
+ */
+void
+SolverStats::lambert_call ( solver_regime regime, double seconds,
+                            int iterations, solver_failure why, int corrections )
+{
+    tally( lambert, regime, seconds, iterations, why, corrections );
+}
+
+/**
+ * Record one kepler() call.
+ * @param regime elliptic, parabolic or hyperbolic.
+ * @param seconds how long it took.
+ * @param iterations Laguerre-Conway iterations.
+ * @param why why it failed, or FAIL_NONE.
+ * @param corrections times the Laguerre-Conway radicand went negative and
+ * had its sign flipped.
+ */
+void
+SolverStats::kepler_call ( solver_regime regime, double seconds,
+                           int iterations, solver_failure why, int corrections )
+{
+    tally( kepler, regime, seconds, iterations, why, corrections );
+}
+
+/**
+ * Write both solvers' statistics, one "solver,metric,value" line each.
+ */
+void
+SolverStats::write ( FILE* fpt )
+{
+    write( fpt, "universal", lambert );
+    write( fpt, "kepler", kepler );
+}
+
+void
+SolverStats::write ( FILE* fpt, const char* solver, const SolverTally& t )
+{
+    for ( int r = 0; r < REGIMES; r++ )
+    {
+        fprintf( fpt, "%s,calls_%s,%ld\n", solver, regime_names[ r ], t.calls[ r ] );
+        fprintf( fpt, "%s,seconds_per_call_%s,%e\n", solver, regime_names[ r ],
+                 ( t.calls[ r ] > 0 ) ? t.seconds[ r ] / t.calls[ r ] : 0.0 );
+    }
+
+    for ( int f = 1; f < FAILURES; f++ )
+        if ( t.failures[ f ] > 0 )
+            fprintf( fpt, "%s,failures_%s,%ld\n", solver, failure_names[ f ], t.failures[ f ] );
+
+    fprintf( fpt, "%s,corrections,%ld\n", solver, t.corrections );
+
+    for ( int b = 0; b < SOLVER_STATS_BINS; b++ )
+        if ( t.iterations[ b ] > 0 )
+            fprintf( fpt, "%s,iterations_%d,%ld\n", solver, b, t.iterations[ b ] );
+}
@@ -0,0 +1,116 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#ifndef _SOLVERSTATS_H_
+#define _SOLVERSTATS_H_
+#include <stdio.h>
+
+#define KEPLER_MAXITER 40       //!< kepler_state()'s iteration limit.
+#define ULAMBERT_MAXITER 40     //!< ULambert::universal()'s iteration limit.
+
+//! iteration histogram bins, the larger limit + 1.
+#define SOLVER_STATS_BINS ( ( KEPLER_MAXITER > ULAMBERT_MAXITER \
+                              ? KEPLER_MAXITER : ULAMBERT_MAXITER ) + 1 )
+
+/**
+ * Orbit regimes, for time per call.  ULambert goes by the sign of psi
+ * when it stops; kepler() goes by the energy of the initial state.
+ */
+enum solver_regime
+{
+    REGIME_ELLIPTIC,
+    REGIME_PARABOLIC,
+    REGIME_HYPERBOLIC,
+    REGIMES             //!< how many regimes there are
+};
+
+/**
+ * Why a solver gave up.
+ */
+enum solver_failure
+{
+    FAIL_NONE,              //!< it didn't.
+    FAIL_ITERATION_LIMIT,   //!< ran out of iterations (kepler() throws 1).
+    FAIL_Y_NEGATIVE,        //!< ULambert: Y stayed negative.
+    FAIL_180_DEGREES,       //!< ULambert: end points 180 degrees apart.
+    FAIL_FG_TOLERANCE,      //!< kepler(): F and G check failed (throws 2).
+    FAILURES                //!< how many reasons there are
+};
+
+/**
+ * What one solver did, over many calls.
+ */
+struct SolverTally
+{
+    long calls[ REGIMES ];              //!< calls, by regime.
+    double seconds[ REGIMES ];          //!< time spent, by regime.
+    long failures[ FAILURES ];          //!< calls, by failure reason.
+    long iterations[ SOLVER_STATS_BINS ];  //!< iteration count histogram.
+    long corrections;                   //!< Y-negative fixes or radicand sign flips.
+};
+
+/**
+ * Solver-internal statistics.
+ * A thread that wants them attaches a SolverStats with attach(); after
+ * that, every ULambert::universal() and kepler() call on that thread
+ * adds to it.  With nothing attached the solvers only pay for checking
+ * a thread-local pointer.  One object per thread, so no locking; add
+ * them up afterwards with +=.
+ */
+class SolverStats
+{
+
+    public:
+        SolverStats ( void );
+        virtual ~SolverStats ( void );
+
+        void clear ( void );
+        SolverStats& operator += ( const SolverStats& );
+
+        // Used by the solvers.
+        void lambert_call ( solver_regime, double, int, solver_failure, int );
+        void kepler_call ( solver_regime, double, int, solver_failure, int );
+
+        void write ( FILE* );  // one "solver,metric,value" line per number.
+
+        static void attach ( SolverStats* );  // NULL to detach.
+
+        SolverTally lambert;  //!< ULambert::universal().
+        SolverTally kepler;   //!< kepler().
+
+    private:
+        static void tally ( SolverTally&, solver_regime, double, int,
+                            solver_failure, int );
+        static void write ( FILE*, const char*, const SolverTally& );
+};
+
+extern __thread SolverStats* solver_stats;  //!< this thread's, or NULL.
+
+#endif /* _SOLVERSTATS_H_ */
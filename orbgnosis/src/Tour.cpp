@@ -30,11 +30,16 @@
 */
 
 #include "Tour.h"
+#include "TourTable.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
-#include <vector>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace std;
 
@@ -45,16 +50,21 @@ using namespace std;
 Tour::Tour (int numTargets) try
 :
     cols( numTargets + 1 ),
-    rows( fact(numTargets) ),
-    order( rows ),
-    rowCtr( 0 )
+    rows( numTargets > TOUR_TABLE_MAXTARGETS ? 0 : fact(numTargets) ),
+    order( NULL ),
+    heap( NULL ),
+    map( NULL ),
+    mapLength( 0 ),
+    rowBytes( tour_table_row_bytes(numTargets + 1) ),
+    rowCtr( 0 ),
+    ready( false )
 {
-    // Resize order to have (rows) rows.
-    order.resize( rows );
-    // Resize each row to hold (cols) columns.
-
-    for ( int i = 0; i < rows; i++ )
-        order[i].resize(cols);
+    if (0 == rows)
+    {
+        // Big tours can't be tabulated; they need a permutation chromosome.
+        cerr << "Tour: " << numTargets << " targets are too many to tabulate.\n";
+        return;
+    }
 
     // create filename
     stringstream s;
@@ -65,30 +75,12 @@ Tour::Tour (int numTargets) try
 
     s >> snum;
 
-    // e.g. ifstream datafile ("data/5.dat");
-    string filename = "data/" + snum + ".dat";
-
-    ifstream datafile (filename.c_str());
-
-    string line;
-
-    if (datafile.is_open())
-    {
-        for (int r = 0; r < rows; r++)
-        {
-            getline (datafile, line);
-
-            for (int c = 0; c < cols; c++)
-            {
-                order[r][c] = atoi(line.substr(c, 1).c_str());
-            }
-        }
-
-        datafile.close();
-    }
+    // e.g. "data/5.tbl", or failing that, "data/5.dat"
+    ready = map_table("data/" + snum + ".tbl")
+            || read_text("data/" + snum + ".dat");
 
-    else
-        cerr << "Could not open file.\n";
+    if ( ! ready )
+        cerr << "Tour: there is no table for " << numTargets << " targets.\n";
 }
 
 catch ( ... )
@@ -105,6 +97,103 @@ catch ( ... )
 Tour::~Tour ( void )
 {
     //cout << "Tour destructor called.\n";
+    if (map != NULL)
+        munmap(map, mapLength);
+
+    delete [] heap;
+}
+
+/**
+ * Memory-map a packed binary table read-only.  Returns false, and leaves
+ * the Tour untouched, if the file is missing or doesn't match this Tour.
+ * @param filename e.g. "data/5.tbl"
+ */
+bool
+Tour::map_table (const string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        return false;   // no binary table, that's fine.
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(tour_table_header))
+    {
+        close(fd);
+        cerr << "Tour: " << filename << " is truncated, ignoring it.\n";
+        return false;
+    }
+
+    void* m = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping stays valid without the descriptor.
+
+    if (m == MAP_FAILED)
+    {
+        cerr << "Tour: could not mmap " << filename << ".\n";
+        return false;
+    }
+
+    const tour_table_header* h = static_cast<const tour_table_header*>(m);
+    size_t need = sizeof(tour_table_header) + (size_t)rows * rowBytes;
+
+    if (memcmp(h->magic, TOUR_TABLE_MAGIC, 4) != 0
+            || h->version != TOUR_TABLE_VERSION
+            || h->cols != (uint32_t)cols
+            || h->rows != (uint32_t)rows
+            || h->row_bytes != rowBytes
+            || (size_t)st.st_size < need)
+    {
+        munmap(m, (size_t)st.st_size);
+        cerr << "Tour: " << filename << " doesn't match, ignoring it.\n";
+        return false;
+    }
+
+    map = m;
+    mapLength = (size_t)st.st_size;
+    order = static_cast<const unsigned char*>(m) + sizeof(tour_table_header);
+    return true;
+}
+
+/**
+ * Parse a legacy text table, one permutation per line, one digit per
+ * node, and pack it into a private buffer.  Returns false, and leaves
+ * the Tour untouched, if the file is missing or too short.
+ * @param filename e.g. "data/5.dat"
+ */
+bool
+Tour::read_text (const string& filename)
+{
+    ifstream datafile (filename.c_str());
+
+    string line;
+
+    if ( ! datafile.is_open())
+        return false;   // the constructor says so.
+
+    heap = new unsigned char [ (size_t)rows * rowBytes ];
+    memset(heap, 0, (size_t)rows * rowBytes);
+
+    for (int r = 0; r < rows; r++)
+    {
+        if ( ! getline (datafile, line) || ((int)line.size() < cols))
+        {
+            cerr << "Tour: " << filename << " is truncated, ignoring it.\n";
+            delete [] heap;
+            heap = NULL;
+            return false;
+        }
+
+        for (int c = 0; c < cols; c++)
+        {
+            tour_table_set(heap + r * rowBytes, c,
+                           atoi(line.substr(c, 1).c_str()));
+        }
+    }
+
+    datafile.close();
+    order = heap;
+    return true;
 }
 
 void
@@ -114,7 +203,7 @@ Tour::printOrder ( void )
     {
         for ( int c = 0; c < cols; c++ )
         {
-            cout << order[r][c] << " ";
+            cout << get_target(r, c) << " ";
         }
 
         cout << "\n";
@@ -133,8 +222,14 @@ Tour::fact (const int k)
     return f;
 }
 
+bool
+Tour::loaded ( void )
+{
+    return ready;
+}
+
 int
 Tour::get_target (int r, int c)
 {
-    return order[r][c];
+    return tour_table_get(order + r * rowBytes, c);
 }
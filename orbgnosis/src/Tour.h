@@ -30,12 +30,16 @@
 
 #ifndef _TOUR_H_
 #define _TOUR_H_
-#include <vector>
+#include <string>
+#include <stddef.h>
 
 using namespace std;
 
 /**
  * All possible permutations of tour order.
+ * The permutations are kept nibble-packed (see TourTable.h).  If a binary
+ * table data/N.tbl exists it is memory-mapped read-only, otherwise the
+ * legacy text table data/N.dat is parsed and packed into a private buffer.
  */
 
 class Tour
@@ -51,12 +55,26 @@ class Tour
         // Accessor method for order.
         int get_target(int, int);
 
+        // False if there was no table to load; get_target() mustn't be used.
+        bool loaded ( void );
+
         const int cols;            // # of targets, or # of columns
         const int rows;            // # of tours, or # of rows
 
     private:
-        vector< vector<int> > order;  // all possible tour orders
-        int rowCtr;                // row counter
+        Tour ( const Tour& );             // not copyable, owns the table
+        Tour& operator = ( const Tour& );
+
+        bool map_table ( const string& ); // mmap a binary table
+        bool read_text ( const string& ); // parse a text table
+
+        const unsigned char* order;  //!< packed tour orders, rows * rowBytes
+        unsigned char* heap;         //!< order, if it was read from text
+        void* map;                   //!< order's mapping, if it was mmap'd
+        size_t mapLength;            //!< length of the mapping
+        size_t rowBytes;             //!< bytes per packed row
+        int rowCtr;                  // row counter
+        bool ready;                  //!< a table was loaded
 };
 
 #endif /* _TOUR_H_ */
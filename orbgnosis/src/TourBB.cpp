@@ -0,0 +1,571 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Branch and bound over a time grid, for the exact discretized front of
+ * the wsp_astro tour problem.
+ */
+
+#include "TourBB.h"
+#include "Kepler.h"
+#include "Transfer.h"
+#include "LambertSolver.h"
+#include "Orbgnosis.h"
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+/**
+ * Set up the grid: snap each leg's ranges to it, propagate every node to
+ * every step, and bound every edge.
+ * @param con the chaser (node 0) and its targets.
+ * @param step the grid step (TU).
+ * @param dwell_lo each leg's least dwell (TU).
+ * @param dwell_hi each leg's most dwell (TU).
+ * @param tof_lo each leg's least time of flight (TU).
+ * @param tof_hi each leg's most time of flight (TU).
+ */
+template <class Solver>
+TourBB<Solver>::TourBB ( Constellation& con, double step,
+                         const vector<double>& dwell_lo,
+                         const vector<double>& dwell_hi,
+                         const vector<double>& tof_lo,
+                         const vector<double>& tof_hi )
+{
+    n = (int)con.t10s.size();
+    nlegs = n - 1;
+    h = step;
+    bounds = true;
+    version = 0;
+    combos = 0.0;
+    legs_priced = 0;
+    nodes = 0;
+    tours = 0;
+
+    if ( ( n < 2 ) || ( n > TOURBB_MAXNODES ) || ( h <= 0.0 ) )
+    {
+        cerr << "TourBB: need 2-" << TOURBB_MAXNODES
+             << " nodes and a positive grid step." << endl;
+        exit( 1 );
+    }
+
+    if ( ( (int)dwell_lo.size() != nlegs ) || ( (int)dwell_hi.size() != nlegs ) ||
+         ( (int)tof_lo.size() != nlegs ) || ( (int)tof_hi.size() != nlegs ) )
+    {
+        cerr << "TourBB: need dwell and TOF ranges for each of "
+             << nlegs << " legs." << endl;
+        exit( 1 );
+    }
+
+    // A range keeps the grid steps inside it.  TOF can't be zero.
+    dlo.resize( nlegs );
+    dhi.resize( nlegs );
+    tlo.resize( nlegs );
+    thi.resize( nlegs );
+    combos = 1.0;
+    ktof = 0;
+
+    for ( int c = 0; c < nlegs; c++ )
+    {
+        dlo[ c ] = max( 0, (int)ceil( dwell_lo[ c ] / h - 1e-9 ) );
+        dhi[ c ] = (int)floor( dwell_hi[ c ] / h + 1e-9 );
+        tlo[ c ] = max( 1, (int)ceil( tof_lo[ c ] / h - 1e-9 ) );
+        thi[ c ] = (int)floor( tof_hi[ c ] / h + 1e-9 );
+
+        if ( ( dlo[ c ] > dhi[ c ] ) || ( tlo[ c ] > thi[ c ] ) )
+        {
+            cerr << "TourBB: leg " << c << " has no grid step in its range." << endl;
+            exit( 1 );
+        }
+
+        combos *= (double)( dhi[ c ] - dlo[ c ] + 1 ) * ( thi[ c ] - tlo[ c ] + 1 );
+        ktof = max( ktof, thi[ c ] + 1 );
+    }
+
+    for ( int k = 2; k < n; k++ )
+        combos *= k;
+
+    rest_lo.assign( nlegs + 1, 0 );
+    rest_hi.assign( nlegs + 1, 0 );
+
+    for ( int c = nlegs - 1; c >= 0; c-- )
+    {
+        rest_lo[ c ] = rest_lo[ c + 1 ] + dlo[ c ] + tlo[ c ];
+        rest_hi[ c ] = rest_hi[ c + 1 ] + dhi[ c ] + thi[ c ];
+    }
+
+    kmax = rest_hi[ 0 ];
+
+    // Every node at every step.  A state Kepler can't reach is lost, and
+    // so is every leg which needs it.
+    const int steps = kmax + 1;
+    states.resize( n * steps );
+    lost.assign( n * steps, 0 );
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for ( int i = 0; i < n * steps; i++ )
+    {
+        int k = i / steps;
+        int s = i % steps;
+
+        try
+        {
+            states[ i ] = ( 0 == s ) ? traj_state( con.t10s[ k ], 0.0 )
+                                     : propagate( con.t10s[ k ], s * h );
+        }
+        catch ( int e )
+        {
+            lost[ i ] = 1;
+        }
+    }
+
+    table.assign( (size_t)n * n * steps * ktof, NAN );
+
+    // The cheapest any leg along an edge could be, whenever it flies.
+    edge_bound.assign( n * n, INF );
+
+    #pragma omp parallel for schedule(dynamic)
+    for ( int e = 0; e < n * n; e++ )
+    {
+        int a = e / n;
+        int b = e % n;
+        double least = INF;
+
+        if ( ( a == b ) || ( 0 == b ) )
+            continue;
+
+        for ( int dep = 0; dep < kmax; dep++ )
+            for ( int kt = 1; ( kt < ktof ) && ( dep + kt <= kmax ); kt++ )
+                least = min( least, leg_bound( a, b, dep, kt ) );
+
+        edge_bound[ e ] = least;
+    }
+}
+
+/**
+ * Nothing to free.
+ */
+template <class Solver>
+TourBB<Solver>::~TourBB ( void )
+{
+}
+
+/**
+ * Find the front.
+ * @param prune true to prune with the bounds, false to reach every tour;
+ * the two find the same front.
+ */
+template <class Solver> void
+TourBB<Solver>::solve ( bool prune )
+{
+    vector<Child> first;
+    Walker root;
+
+    bounds = prune;
+    front.clear();
+    version = 0;
+    legs_priced = 0;
+    nodes = 0;
+    tours = 0;
+
+    // Each thread takes first legs, cheapest bound first.
+    root.order[ 0 ] = 0;
+    root.seen_version = -1;
+    root.nodes = root.priced = root.tours = 0;
+    children( 0, 0, 1u, 0, 0.0, root, first );
+    nodes = 1;
+
+    #pragma omp parallel
+    {
+        Walker w;
+        w.order[ 0 ] = 0;
+        w.seen_version = -1;
+        w.nodes = w.priced = w.tours = 0;
+
+        #pragma omp for schedule(dynamic, 1)
+        for ( int i = 0; i < (int)first.size(); i++ )
+            expand( 0, 0, 1u, 0, 0.0, first[ i ], w );
+
+        #pragma omp critical (tourbb_counts)
+        {
+            legs_priced += w.priced;
+            nodes += w.nodes;
+            tours += w.tours;
+        }
+    }
+}
+
+/**
+ * List the children of a partial tour worth trying, cheapest bound first.
+ * @param c the leg to choose.
+ * @param cur the node it leaves.
+ * @param visited nodes already in the tour, as bits.
+ * @param T the grid step the tour arrived at cur.
+ * @param dv the delta-V so far (ER/TU).
+ * @param w this thread's walker.
+ * @param out the children.
+ */
+template <class Solver> void
+TourBB<Solver>::children ( int c, int cur, unsigned visited, int T, double dv,
+                           Walker& w, vector<Child>& out )
+{
+    out.clear();
+
+    if ( bounds )
+        refresh( w );
+
+    for ( int e = 1; e < n; e++ )
+    {
+        if ( visited & ( 1u << e ) )
+            continue;
+
+        double rest = 0.0;
+
+        if ( bounds )
+            rest = rest_bound( e, visited | ( 1u << e ) );
+
+        for ( int kd = dlo[ c ]; kd <= dhi[ c ]; kd++ )
+        {
+            int dep = T + kd;
+
+            for ( int kt = tlo[ c ]; kt <= thi[ c ]; kt++ )
+            {
+                Child ch;
+                ch.bound = 0.0;
+                ch.end = e;
+                ch.kd = kd;
+                ch.kt = kt;
+
+                if ( bounds )
+                {
+                    int arr = dep + kt;
+                    double lb = dv + leg_bound( cur, e, dep, kt ) + rest;
+
+                    if ( lb >= INF )
+                        continue;
+
+                    // Even the slowest finish breaks the delta-V constraint.
+                    if ( 4.0 * lb * ERTU > ( arr + rest_hi[ c + 1 ] ) * h * TU_MIN )
+                        continue;
+
+                    if ( dominated( w.seen, ( arr + rest_lo[ c + 1 ] ) * h * TU_MIN,
+                                    lb * ERTU ) )
+                        continue;
+
+                    ch.bound = lb;
+                }
+
+                out.push_back( ch );
+            }
+        }
+    }
+
+    if ( bounds )
+        stable_sort( out.begin(), out.end() );
+}
+
+/**
+ * Fly one child's leg, then finish the tour or search on from it.
+ * @param c the leg.
+ * @param cur the node it leaves.
+ * @param visited nodes already in the tour, not counting the child's.
+ * @param T the grid step the tour arrived at cur.
+ * @param dv the delta-V so far (ER/TU).
+ * @param ch the child.
+ * @param w this thread's walker.
+ */
+template <class Solver> void
+TourBB<Solver>::expand ( int c, int cur, unsigned visited, int T, double dv,
+                         const Child& ch, Walker& w )
+{
+    int dep = T + ch.kd;
+    int arr = dep + ch.kt;
+    double d;
+
+    w.order[ c + 1 ] = ch.end;
+    w.dwell[ c ] = ch.kd;
+    w.tof[ c ] = ch.kt;
+
+    // The front may have moved on since the child was made.
+    if ( bounds )
+    {
+        refresh( w );
+
+        if ( dominated( w.seen, ( arr + rest_lo[ c + 1 ] ) * h * TU_MIN,
+                        ch.bound * ERTU ) )
+            return;
+    }
+
+    d = leg( cur, ch.end, dep, ch.kt, w.xfer, w.priced );
+
+    if ( d >= INF )
+        return; // a failed leg fails the tour.
+
+    dv += d;
+    visited |= 1u << ch.end;
+
+    if ( c == nlegs - 1 )
+    {
+        w.tours++;
+
+        if ( 4.0 * dv * ERTU <= arr * h * TU_MIN )
+            offer( w, arr, dv );
+
+        return;
+    }
+
+    // Now the leg's price is known, bound again.
+    if ( bounds )
+    {
+        double lb = dv + rest_bound( ch.end, visited );
+
+        if ( ( lb >= INF ) ||
+             ( 4.0 * lb * ERTU > ( arr + rest_hi[ c + 1 ] ) * h * TU_MIN ) ||
+             dominated( w.seen, ( arr + rest_lo[ c + 1 ] ) * h * TU_MIN, lb * ERTU ) )
+            return;
+    }
+
+    vector<Child> next;
+
+    w.nodes++;
+    children( c + 1, ch.end, visited, arr, dv, w, next );
+
+    for ( size_t i = 0; i < next.size(); i++ )
+        expand( c + 1, ch.end, visited, arr, dv, next[ i ], w );
+}
+
+/**
+ * Copy the front's points, if it has changed since the last copy.
+ */
+template <class Solver> void
+TourBB<Solver>::refresh ( Walker& w )
+{
+    int v;
+
+    #pragma omp atomic read
+    v = version;
+
+    if ( v == w.seen_version )
+        return;
+
+    #pragma omp critical (tourbb_front)
+    {
+        w.seen.resize( front.size() );
+
+        for ( size_t i = 0; i < front.size(); i++ )
+            w.seen[ i ] = make_pair( front[ i ].t, front[ i ].dv );
+
+        w.seen_version = version;
+    }
+}
+
+/**
+ * The delta-V of one leg, priced the first time any thread asks for it.
+ * Two threads may both price a leg; they get the same answer.
+ * @param a the node it leaves.
+ * @param b the node it reaches.
+ * @param dep the departure step.
+ * @param kt the time of flight, in steps.
+ * @param xfer this thread's solver.
+ * @param priced counts best_transfer() calls.
+ * @return the delta-V (ER/TU), INF if there is no transfer.
+ */
+template <class Solver> double
+TourBB<Solver>::leg ( int a, int b, int dep, int kt, Solver& xfer,
+                      long long& priced )
+{
+    const int steps = kmax + 1;
+    size_t i = ( ( (size_t)a * n + b ) * steps + dep ) * ktof + kt;
+    double d;
+
+    #pragma omp atomic read
+    d = table[ i ];
+
+    if ( ! isnan( d ) )
+        return d;
+
+    const int from = a * steps + dep;
+    const int to = b * steps + dep + kt;
+
+    if ( lost[ from ] || lost[ to ] )
+        d = INF;
+    else
+    {
+        d = best_transfer( xfer, states[ from ].r, states[ from ].v,
+                           states[ to ].r, states[ to ].v, kt * h ).dv;
+        priced++;
+    }
+
+    #pragma omp atomic write
+    table[ i ] = d;
+
+    return d;
+}
+
+/**
+ * A lower bound on one leg's delta-V, without pricing it.
+ * @return the bound (ER/TU), INF if the leg can't be flown.
+ */
+template <class Solver> double
+TourBB<Solver>::leg_bound ( int a, int b, int dep, int kt ) const
+{
+    const int steps = kmax + 1;
+    const int from = a * steps + dep;
+    const int to = b * steps + dep + kt;
+
+    if ( lost[ from ] || lost[ to ] )
+        return INF;
+
+    // dv_bound() gives up a little slack, which can take it below zero.
+    return max( 0.0, dv_bound( states[ from ].r, states[ from ].v,
+                               states[ to ].r, states[ to ].v ) );
+}
+
+/**
+ * A lower bound on the delta-V of the legs still to come: each unvisited
+ * node has to be flown into from somewhere, either from another unvisited
+ * node or from the one the tour is at now.
+ * @param e the node the tour is at.
+ * @param visited nodes in the tour so far, e included, as bits.
+ * @return the bound (ER/TU), INF if some node can't be reached.
+ */
+template <class Solver> double
+TourBB<Solver>::rest_bound ( int e, unsigned visited ) const
+{
+    double sum = 0.0;
+
+    for ( int u = 1; u < n; u++ )
+    {
+        if ( visited & ( 1u << u ) )
+            continue;
+
+        double least = edge_bound[ e * n + u ];
+
+        for ( int v = 1; v < n; v++ )
+            if ( ( v != u ) && ! ( visited & ( 1u << v ) ) )
+                least = min( least, edge_bound[ v * n + u ] );
+
+        sum += least;
+    }
+
+    return sum;
+}
+
+/**
+ * Is a point strictly dominated by a copy of the front?  Equal points are
+ * kept, so that ties are settled the same way on any number of threads.
+ * @param seen the front's points, by increasing time.
+ * @param t time (minutes).
+ * @param dv delta-V (m/s).
+ */
+template <class Solver> bool
+TourBB<Solver>::dominated ( const vector< pair<double, double> >& seen,
+                            double t, double dv ) const
+{
+    // The last point no later than t has the least delta-V of those.
+    vector< pair<double, double> >::const_iterator p =
+        upper_bound( seen.begin(), seen.end(), make_pair( t, INF ) );
+
+    if ( p == seen.begin() )
+        return false;
+
+    --p;
+    return ( p->second <= dv ) && ( ( p->first < t ) || ( p->second < dv ) );
+}
+
+/**
+ * Add a feasible tour to the front, if nothing on it dominates the tour,
+ * and drop whatever the tour dominates.  Of equal tours the front keeps
+ * the least (order, dwell, tof).
+ * @param w the walker holding the tour.
+ * @param arr the step it ends on.
+ * @param dv its delta-V (ER/TU).
+ */
+template <class Solver> void
+TourBB<Solver>::offer ( const Walker& w, int arr, double dv )
+{
+    BBTour t;
+
+    t.t = arr * h * TU_MIN;
+    t.dv = dv * ERTU;
+    t.order.assign( w.order, w.order + n );
+    t.dwell.assign( w.dwell, w.dwell + nlegs );
+    t.tof.assign( w.tof, w.tof + nlegs );
+
+    #pragma omp critical (tourbb_front)
+    {
+        size_t pos = 0;
+        bool keep = true;
+
+        while ( ( pos < front.size() ) && ( front[ pos ].t <= t.t ) )
+            pos++;
+
+        if ( ( pos > 0 ) && ( front[ pos - 1 ].dv <= t.dv ) )
+        {
+            BBTour& f = front[ pos - 1 ];
+
+            if ( ( f.t == t.t ) && ( f.dv == t.dv ) &&
+                 ( ( t.order < f.order ) ||
+                   ( ( t.order == f.order ) &&
+                     ( ( t.dwell < f.dwell ) ||
+                       ( ( t.dwell == f.dwell ) && ( t.tof < f.tof ) ) ) ) ) )
+                f = t;
+
+            keep = false;
+        }
+
+        if ( keep )
+        {
+            size_t start = pos, end = pos;
+
+            while ( ( start > 0 ) && ( front[ start - 1 ].t == t.t ) )
+                start--;
+
+            while ( ( end < front.size() ) && ( front[ end ].dv >= t.dv ) )
+                end++;
+
+            front.erase( front.begin() + start, front.begin() + end );
+            front.insert( front.begin() + start, t );
+
+            #pragma omp atomic
+            version++;
+        }
+    }
+}
+
+template class TourBB<UniversalSolver>;
+template class TourBB<BattinSolver>;
@@ -0,0 +1,162 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Branch and bound over a time grid, for the exact discretized front of
+ * the wsp_astro tour problem.
+ */
+
+#ifndef _TOURBB_H_
+#define _TOURBB_H_
+
+#include "Constellation.h"
+#include "TrajState.h"
+#include <vector>
+
+using namespace std;
+
+#define TOURBB_MAXNODES 32  //!< visited nodes are bits of an unsigned.
+
+/**
+ * One tour of the grid and what it costs.
+ */
+struct BBTour
+{
+    double t;               //!< total time (minutes), objective 0.
+    double dv;              //!< total delta-V (m/s), objective 1.
+    vector<int> order;      //!< nodes in visiting order, from 0.
+    vector<int> dwell;      //!< each leg's dwell, in grid steps.
+    vector<int> tof;        //!< each leg's time of flight, in grid steps.
+};
+
+/**
+ * The wsp_astro problem with every dwell and time of flight a whole number
+ * of grid steps, solved exactly: the Pareto front of total time against
+ * total delta-V, over every order and every grid timing, of the tours
+ * which satisfy wsp_astro's constraints.  The GA works in continuous time,
+ * so this front is a yardstick for it, not an upper bound on it.
+ *
+ * Since every time is on the grid, each leg is fixed by its two nodes,
+ * departure step and time of flight, and is priced (with best_transfer())
+ * at most once, however many tours share it.  Target states are
+ * propagated to every grid step up front.
+ *
+ * The search is depth first over (next node, dwell, time of flight), and
+ * a partial tour is dropped when a lower bound on its completion is
+ * dominated by a tour already found or already breaks the delta-V
+ * constraint.  The bounds are admissible:
+ *   - time: the smallest dwell and time of flight of every leg to come;
+ *   - delta-V: dv_bound() for the next leg, before it is priced, and for
+ *     the legs after it, each unvisited node's cheapest way in, by the
+ *     smallest dv_bound() over the whole grid of the edge.
+ * Children are tried cheapest bound first, to find good tours early.
+ *
+ * The first leg's choices are spread across threads.  The leg table is
+ * shared; the front is shared under a lock, and each thread prunes
+ * against its own copy, refreshed whenever the front changes.
+ */
+template <class Solver>
+class TourBB
+{
+
+    public:
+        TourBB ( Constellation&,            // node 0 is the chaser
+                 double,                    // grid step (TU)
+                 const vector<double>&,     // each leg's least dwell
+                 const vector<double>&,     // ... and most
+                 const vector<double>&,     // each leg's least TOF
+                 const vector<double>& );   // ... and most
+
+        virtual ~TourBB ( void );
+
+        void solve ( bool );    // false to enumerate with no bounds
+
+        vector<BBTour> front;   //!< the front, by increasing time.
+        double combos;          //!< tours on the grid, every order.
+        long long legs_priced;  //!< best_transfer() calls.
+        long long nodes;        //!< partial tours expanded.
+        long long tours;        //!< complete tours reached.
+
+    private:
+        struct Child
+        {
+            double bound;   //!< delta-V lower bound of the whole tour.
+            int end;        //!< next node.
+            int kd;         //!< dwell steps.
+            int kt;         //!< TOF steps.
+
+            // Cheapest bound first.
+            bool operator< ( const Child& o ) const { return bound < o.bound; }
+        };
+
+        /**
+         * What each thread carries down the search.
+         */
+        struct Walker
+        {
+            Solver xfer;                            //!< its own solver.
+            int order[ TOURBB_MAXNODES ];           //!< the tour so far.
+            int dwell[ TOURBB_MAXNODES ];           //!< its dwells.
+            int tof[ TOURBB_MAXNODES ];             //!< its TOFs.
+            vector< pair<double, double> > seen;    //!< copy of front.
+            int seen_version;                       //!< of that copy.
+            long long nodes, priced, tours;         //!< counts.
+        };
+
+        void children ( int, int, unsigned, int, double, Walker&,
+                        vector<Child>& );
+        void expand ( int, int, unsigned, int, double, const Child&, Walker& );
+        void refresh ( Walker& );
+        double leg ( int, int, int, int, Solver&, long long& );
+        double leg_bound ( int, int, int, int ) const;
+        double rest_bound ( int, unsigned ) const;
+        bool dominated ( const vector< pair<double, double> >&, double, double ) const;
+        void offer ( const Walker&, int, double );
+
+        int n;                      //!< nodes, chaser included.
+        int nlegs;                  //!< legs of a tour, n - 1.
+        double h;                   //!< grid step (TU).
+        bool bounds;                //!< prune, or enumerate everything.
+        vector<int> dlo, dhi;       //!< each leg's dwell range, in steps.
+        vector<int> tlo, thi;       //!< each leg's TOF range, in steps.
+        vector<int> rest_lo;        //!< least steps of legs c and after.
+        vector<int> rest_hi;        //!< most steps of legs c and after.
+        int kmax;                   //!< last grid step a tour can reach.
+        int ktof;                   //!< largest TOF, in steps, + 1.
+
+        vector<TrajState> states;   //!< node k at step s: k * (kmax+1) + s.
+        vector<char> lost;          //!< propagation failed at that step.
+        vector<double> table;       //!< leg delta-V, NaN until priced.
+        vector<double> edge_bound;  //!< least dv_bound() of each edge.
+
+        int version;                //!< bumped whenever front changes.
+};
+
+#endif /* _TOURBB_H_ */
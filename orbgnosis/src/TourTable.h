@@ -0,0 +1,102 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * The packed binary permutation table format (data/N.tbl).
+ *
+ * A table file is a fixed size header followed by rows*row_bytes bytes of
+ * permutation data.  Every entry of a tour order is a node number below 16,
+ * so each row is packed two entries per byte: even columns live in the low
+ * nibble, odd columns in the high nibble.  The file is written by
+ * sjt_test/SJT.c and memory-mapped read-only by Tour, so any number of
+ * orbgnosis processes share one copy in the page cache.
+ *
+ * This header is shared by C and C++ code, so keep it plain C.
+ */
+
+#ifndef _TOURTABLE_H_
+#define _TOURTABLE_H_
+
+#include <stdint.h>
+
+#define TOUR_TABLE_MAGIC   "OTBL"  //!< first four bytes of every table file
+#define TOUR_TABLE_VERSION 1       //!< bump this if the layout ever changes
+#define TOUR_TABLE_MAXCOLS 16      //!< a nibble can't hold node numbers > 15
+#define TOUR_TABLE_MAXTARGETS 9    //!< "make tables" builds 1.tbl to 9.tbl
+
+/**
+ * Table file header.  Six 32-bit words, so the packed rows which follow
+ * start on an 8 byte boundary.  Fields are in native byte order; the
+ * version word doubles as a byte order check.
+ */
+typedef struct
+{
+    char     magic[4];   //!< TOUR_TABLE_MAGIC, not null terminated
+    uint32_t version;    //!< TOUR_TABLE_VERSION
+    uint32_t cols;       //!< nodes per tour, including the start node
+    uint32_t rows;       //!< number of tours (permutations)
+    uint32_t row_bytes;  //!< bytes per packed row, (cols + 1) / 2
+    uint32_t reserved;   //!< always zero
+}
+
+tour_table_header;
+
+/**
+ * Bytes needed to pack one row of (cols) nibbles.
+ */
+static inline uint32_t
+tour_table_row_bytes (uint32_t cols)
+{
+    return (cols + 1) / 2;
+}
+
+/**
+ * Read column c of a packed row.
+ */
+static inline int
+tour_table_get (const unsigned char *row, int c)
+{
+    unsigned char b = row[c >> 1];
+    return (c & 1) ? (b >> 4) : (b & 0x0f);
+}
+
+/**
+ * Write node number n into column c of a packed row.
+ */
+static inline void
+tour_table_set (unsigned char *row, int c, int n)
+{
+    if (c & 1)
+        row[c >> 1] = (unsigned char)((row[c >> 1] & 0x0f) | ((n & 0x0f) << 4));
+    else
+        row[c >> 1] = (unsigned char)((row[c >> 1] & 0xf0) | (n & 0x0f));
+}
+
+#endif /* _TOURTABLE_H_ */
@@ -28,9 +28,11 @@
 * Contributor(s):  Ted Stodgell <trs137@psu.edu>
 */
 
+#include "Anomaly.h"
 #include "Orbgnosis.h"
 #include "Stumpff.h"
 #include "Traj.h"
+#include "TrajState.h"
 #include "Vec3.h"
 #include <iostream>
 #include <math.h>
@@ -46,6 +48,7 @@ Traj::Traj ( void ) : a( 0.0 ), e( 0.0 ), i( 0.0 ), raan( 0.0 ), w( 0.0 ), f( 0.
         E( NAN ), M( NAN ), argLat( NAN ), lonTrue( NAN ), lonPer( NAN ),
         raan_dot( 0.0 ),
         w_dot( 0.0 ),
+        M_dot( 0.0 ),
         e_vector( 0.0, 0.0, 0.0 ),
         h_vector( 0.0, 0.0, 0.0 ),
         n_vector( 0.0, 0.0, 0.0 )
@@ -72,6 +75,7 @@ Traj::Traj ( double ain, double ein, double iin, double raanin, double win,
         E( NAN ), M( NAN ), argLat( NAN ), lonTrue( NAN ), lonPer( NAN ),
         raan_dot( 0.0 ),
         w_dot( 0.0 ),
+        M_dot( 0.0 ),
         e_vector( 0.0, 0.0, 0.0 ),
         h_vector( 0.0, 0.0, 0.0 ),
         n_vector( 0.0, 0.0, 0.0 )
@@ -94,6 +98,7 @@ Traj::Traj ( Vec3 rin, Vec3 vin ) :
         E( NAN ), M( NAN ), argLat( NAN ), lonTrue( NAN ), lonPer( NAN ),
         raan_dot( 0.0 ),
         w_dot( 0.0 ),
+        M_dot( 0.0 ),
         e_vector( 0.0, 0.0, 0.0 ),
         h_vector( 0.0, 0.0, 0.0 ),
         n_vector( 0.0, 0.0, 0.0 )
@@ -122,6 +127,7 @@ Traj::Traj ( const Traj& copy ) :
         lonPer( copy.lonPer ),
         raan_dot( copy.raan_dot),
         w_dot( copy.w_dot ),
+        M_dot( copy.M_dot ),
         e_vector( copy.e_vector ),
         h_vector( copy.h_vector ),
         n_vector( copy.n_vector )
@@ -153,6 +159,7 @@ Traj::operator = ( Traj t )
         lonPer = t.lonPer;
         raan_dot = t.raan_dot;
         w_dot = t.w_dot;
+        M_dot = t.M_dot;
         e_vector = t.e_vector;
         h_vector = t.h_vector;
         n_vector = t.n_vector;
@@ -288,6 +295,11 @@ double Traj::get_w_dot ( void )
     return w_dot;
 }
 
+double Traj::get_M_dot ( void )
+{
+    return M_dot;
+}
+
 Vec3 Traj::get_e_vector ( void )
 {
     return e_vector;
@@ -502,115 +514,15 @@ Traj::set_v ( Vec3 vin )
 
 /**
  * Mutator method for mean anomaly.  Automatically re-calculates.
- * everything else.  Only to be used for elliptical orbits.
+ * everything else.  See mean_to_true() for setting many at once.
  * @param min the mean anomaly.
  */
 void
 Traj::set_M( double min )
 {
     M = min;
-    const double limit = 50;    // iteraton limit
-    int count;                  // iteration counter
-    double Eold, Enew;          // next eccentric anomaly value
-    double sinf, cosf;          // sine and cosine of true anomaly
-
-    if (e > 1.0) // Hyperbolic trajectory if e is over 1.
-    {
-        // Set up initial guess
-
-        if (e < 1.6)
-        {
-            if ((M < 0.0) && (M > -M_PI) || (M > M_PI))
-            {
-                Eold = M - e;
-            }
-
-            else
-            {
-                Eold = M + e;
-            }
-        }
-
-        else
-        {
-            if ((e < 3.6) && (fabs(M) > M_PI))
-            {
-                if (M > 0.0)
-                {
-                    Eold = M - e;
-                }
-
-                else
-                {
-                    Eold = M + e;
-                }
-            }
-
-            else
-            {
-                Eold = M / (e - 1.0);
-            }
-        }
-
-        count = 1;
-        Enew = Eold + ((M - e * sinh(Eold) + Eold) / (E * cosh(Eold) - 1.0));
-
-        while ((fabs(Enew - Eold) > SMALL) && (count < limit))
-        {
-            Eold = Enew;
-            Enew = Eold + ((M - e * sinh(Eold) + Eold) / (E * cosh(Eold) - 1.0));
-            count = count + 1;
-        }
-
-        sinf = -(sqrt(e * e - 1.0) * sinh(Enew)) / (1.0 - e * cosh(Enew));
-        cosf = (cosh(Enew) - e) / (1.0 - e * cosh(Enew));
-        f = atan2(sinf, cosf);
-    }
-    else
-    {
-        if (e > SMALL) // Elliptical
-        {
-
-            if (((M > 0.0) && (M > -M_PI)) || (M > M_PI))
-            {
-                Eold = M - e;
-            }
-
-            else
-            {
-                Eold = M + e;
-            }
-
-            count = 1;
-            Enew = Eold + (M - Eold + e * sin(Eold)) / (1.0 - e * cos(Eold));
-
-            while ((fabs(Enew - Eold) > SMALL) && (count <= limit))
-            {
-                Eold = Enew;
-                Enew = Eold + (M - Eold + e * sin(Eold)) / (1.0 - e * cos(Eold));
-                count = count + 1;
-            }
-
-            sinf = (sqrt(1.0 - e * e) * sin(Enew)) / (1.0 - e * cos(Enew));
-            cosf = (cos(Enew) - e) / (1.0 - e * cos(Enew));
-            f = atan2(sinf, cosf);
-        }
-        else // Circular
-        {
-            count = 0;
-            f = M;
-            Enew = M;
-        }
-    }
-
-    if (count > limit)
-    {
-        cerr << "set_M() failed to converge while calculating E from M." << endl;
-        exit(1);
-    }
-
-    E = Enew;
-    randv();
+    mean_to_true( 1, &M, &e, &f );
+    randv();  // E comes along with f.
 }
 
 /**
@@ -627,26 +539,7 @@ Traj::randv()
     // Elements are needed to specify the orbit they will
     // have already been defined.
 
-    // Calculate semilatus rectum or semiparameter
-    double p = a * ( 1 - e * e );
-
-    // Calculate some temporary values
-    double cos_f = cos( f );
-    double sin_f = sin( f );
-    double temp = p / ( 1.0 + e * cos_f );
-
-    // Calculate position and velocity in PQW frame of reference.
-    Vec3 r_pqw( ( temp * cos_f ), ( temp * sin_f ), ( 0.0 ) );
-
-    if ( fabs( p ) < SMALL )
-        p = SMALL;
-
-    Vec3 v_pqw( ( -sin_f / sqrt( p ) ), ( ( e + cos_f ) / sqrt( p ) ), 0.0 );
-
-    // Transform orbital frame of reference to geocentric equitorial
-    r = rotZ( rotX( rotZ( r_pqw, w ), i ), raan );
-
-    v = rotZ( rotX( rotZ( v_pqw, w ), i ), raan );
+    elements_to_rv( a, e, i, raan, w, f, r, v );
 
     // Fill in e_ h_ and n_vectors.
     double rr = norm( r );
@@ -867,7 +760,8 @@ Traj::special()
 
 /**
  * This private function is used by randv() and elorb() to calculate
- * the secular components of J2's effect on raan and w.
+ * the secular components of J2's effect on raan, w and M.
+ * See Vallado, "Fundamentals of Astrodynamics and Applications," sec. 9.6.
  */
 void
 Traj::find_J2_rates()
@@ -876,13 +770,16 @@ Traj::find_J2_rates()
     {
         double n = sqrt( 1.0 / (a * a * a)); // mean motion;
         double p = a * (1 - e * e);            // semiparameter;
-        raan_dot = -3.0 * n * J2 / (2.0 * p * p);
-        w_dot = 3.0 * n * J2 * (4.0 - 5.0 * sin(i) * sin(i))
+        double sin2i = sin(i) * sin(i);
+        raan_dot = -3.0 * n * J2 * cos(i) / (2.0 * p * p);
+        w_dot = 3.0 * n * J2 * (4.0 - 5.0 * sin2i)
                 / (4.0 * p * p);
+        M_dot = n * (1.0 + 3.0 * J2 * sqrt(1.0 - e * e) * (2.0 - 3.0 * sin2i)
+                     / (4.0 * p * p));
     }
     else
     {
-        raan_dot = w_dot = 0.0;
+        raan_dot = w_dot = M_dot = 0.0;
     }
 }
 
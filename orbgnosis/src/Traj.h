@@ -81,6 +81,7 @@ class Traj
         double get_lonPer ( void );
         double get_raan_dot (void );
         double get_w_dot (void );
+        double get_M_dot (void );
         Vec3 get_e_vector ( void );
         Vec3 get_h_vector ( void );
         Vec3 get_n_vector ( void );
@@ -122,6 +123,7 @@ class Traj
         // SECULAR J2 EFFECTS
         double raan_dot; //!< Nodal regression (radians/TU)
         double w_dot;    //!< Apsidal regression (radians/TU).
+        double M_dot;    //!< Mean motion, with J2's secular drift (radians/TU).
 
         // OTHER VECTORS:
         Vec3 e_vector;  //!< Eccentricity
@@ -0,0 +1,116 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * The compact state of a body: where it is, how fast it's going, and when.
+ */
+
+#ifndef _TRAJSTATE_H_
+#define _TRAJSTATE_H_
+#include "Vec3.h"
+#include "Orbgnosis.h"
+#include "Traj.h"
+#include <math.h>
+#include <type_traits>
+
+/**
+ * A state vector and its epoch, and nothing else.  Traj keeps the
+ * classical elements, the other anomalies and the J2 rates up to date
+ * with every change, which is a lot to build and copy for a leg of a tour
+ * that only reads r and v.  TrajState is seven doubles, trivially
+ * copyable, and what kepler_state(), propagate() and the leg pricing pass
+ * around.  Convert to and from Traj only where elements are needed.
+ */
+struct TrajState
+{
+    Vec3 r;     //!< position (ER).
+    Vec3 v;     //!< velocity (ER/TU).
+    double t;   //!< epoch (TU).
+};
+
+// The evaluator counts on these staying plain memory; see STAT_EVAL_ALLOCS.
+static_assert( std::is_trivially_copyable<Vec3>::value, "Vec3 must be trivially copyable" );
+static_assert( std::is_trivially_copyable<TrajState>::value, "TrajState must be trivially copyable" );
+
+/**
+ * The state of a trajectory.
+ * @param traj the trajectory.
+ * @param t its epoch.
+ */
+inline TrajState
+traj_state ( Traj& traj, double t )
+{
+    TrajState s;
+
+    s.r = traj.get_r();
+    s.v = traj.get_v();
+    s.t = t;
+    return s;
+}
+
+/**
+ * Position and velocity from classical elements, as Traj::randv() works
+ * them out, without building a Traj.
+ * @param a semimajor axis (ER).
+ * @param e eccentricity.
+ * @param i inclination.
+ * @param raan right ascension of the ascending node.
+ * @param w argument of perigee.
+ * @param f true anomaly.
+ * @param r gets the position (ER).
+ * @param v gets the velocity (ER/TU).
+ */
+inline void
+elements_to_rv ( double a, double e, double i, double raan, double w,
+                 double f, Vec3& r, Vec3& v )
+{
+    // Calculate semilatus rectum or semiparameter
+    double p = a * ( 1 - e * e );
+
+    // Calculate some temporary values
+    double cos_f = cos( f );
+    double sin_f = sin( f );
+    double temp = p / ( 1.0 + e * cos_f );
+
+    // Calculate position and velocity in PQW frame of reference.
+    Vec3 r_pqw( ( temp * cos_f ), ( temp * sin_f ), ( 0.0 ) );
+
+    if ( fabs( p ) < SMALL )
+        p = SMALL;
+
+    Vec3 v_pqw( ( -sin_f / sqrt( p ) ), ( ( e + cos_f ) / sqrt( p ) ), 0.0 );
+
+    // Transform orbital frame of reference to geocentric equitorial
+    r = rotZ( rotX( rotZ( r_pqw, w ), i ), raan );
+
+    v = rotZ( rotX( rotZ( v_pqw, w ), i ), raan );
+}
+
+#endif /* _TRAJSTATE_H_ */
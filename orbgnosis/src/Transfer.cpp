@@ -0,0 +1,115 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#include <math.h>
+#include "Vec3.h"
+#include "Orbgnosis.h"
+#include "Kepler.h"
+#include "Transfer.h"
+
+using namespace std;
+
+/**
+ * The Lambert solver strategy the runtime selectors pick.  main() sets
+ * it from the command line; nothing changes it once legs are being priced.
+ */
+lambert_method leg_method = LAMBERT_UNIVERSAL;
+
+/**
+ * The propagator propagate() uses.  main() sets it from the command line;
+ * nothing changes it once targets are being propagated.
+ */
+propagator target_propagator = PROPAGATE_TWO_BODY;
+
+/**
+ * Slack taken off every bound (ER/TU, about 0.008 m/s), so a bound is never
+ * more than a transfer which a solver's rounding or convergence tolerance
+ * priced just under it.
+ */
+#define BOUND_SLACK 1.0e-6
+
+/**
+ * Speed change needed to move from speed v at radius r onto an orbit of
+ * specific energy E.
+ */
+static double
+speed_change ( double E, double r, double v )
+{
+    return fabs(sqrt(2.0 * (E + 1.0 / r)) - v);
+}
+
+/**
+ * A lower bound on the delta-V of any two-burn transfer between two
+ * states, from their orbits alone.  It is the larger of two bounds.
+ *
+ * Angular momentum: the first burn changes h by R_start x dV1 and the
+ * second by R_end x dV2, so |h_end - h_start| can't exceed max(r1, r2)
+ * times the total delta-V.  This prices plane changes, and changes in the
+ * size and shape of the orbit.
+ *
+ * Energy, a Hohmann-type minimum: a transfer orbit of energy E costs at
+ * least |v(E, r1) - v1| + |v2 - v(E, r2)|, the speed changes alone.  That
+ * is smallest at the energy of whichever end is further from Earth (all
+ * of the energy change is done at the lower, faster end) and grows away
+ * from it.  The transfer orbit reaches both radii, which limits E from
+ * below.
+ *
+ * The bound holds for every revs branch and both solvers.  It can't be
+ * tightened per branch: universal() resets its bisection bracket after
+ * the first step, so a multi-rev branch may return an arc with fewer
+ * revolutions than asked for.
+ *
+ * @param R_start position at departure.
+ * @param V_start velocity at departure, before the first burn.
+ * @param R_end position at arrival.
+ * @param V_end velocity at arrival, after the second burn.
+ * @return the bound, ER/TU.
+ */
+double
+dv_bound ( Vec3 R_start, Vec3 V_start, Vec3 R_end, Vec3 V_end )
+{
+    double r1 = norm(R_start);
+    double r2 = norm(R_end);
+    double v1 = norm(V_start);
+    double v2 = norm(V_end);
+    double r_max = (r1 > r2) ? r1 : r2;
+    double E = (r1 > r2) ? 0.5 * v1 * v1 - 1.0 / r1
+                         : 0.5 * v2 * v2 - 1.0 / r2;
+    double dv_h, dv_E;
+
+    dv_h = norm(cross(R_end, V_end) - cross(R_start, V_start)) / r_max;
+
+    if (E < -1.0 / r_max)
+        E = -1.0 / r_max;
+
+    dv_E = speed_change(E, r1, v1) + speed_change(E, r2, v2);
+
+    return ((dv_h > dv_E) ? dv_h : dv_E) - BOUND_SLACK;
+}
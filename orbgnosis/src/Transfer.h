@@ -0,0 +1,168 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+#ifndef _TRANSFER_H_
+#define _TRANSFER_H_
+#include <math.h>
+#include "Vec3.h"
+#include "HitEarth.h"
+#include "LambertSolver.h"
+#include "Orbgnosis.h"
+#include "RunStats.h"
+
+/**
+ * The cheapest prograde Lambert transfer found for one leg of a tour.
+ */
+struct Transfer
+{
+    double dv;      //!< delta-V of both burns (ER/TU), INF if none was found.
+    int revs;       //!< complete revolutions of the best transfer arc.
+    bool longway;   //!< true if the best transfer arc sweeps more than pi.
+};
+
+extern lambert_method leg_method;  //!< set once, before any legs are priced.
+
+// Lower bound on the delta-V of any transfer for one leg.
+double dv_bound ( Vec3,       // position at departure
+                  Vec3,       // velocity before the first burn
+                  Vec3,       // position at arrival
+                  Vec3 );     // velocity after the second burn
+
+/**
+ * Price one Lambert solution: the delta-V of both burns, or INF if the
+ * solver failed or the transfer arc hits the Earth.
+ */
+inline double
+leg_dv ( bool failed, Vec3 Vo, Vec3 V, Vec3 R_start, Vec3 V_start,
+         Vec3 R_end, Vec3 V_end )
+{
+    STAT_INC(STAT_LAMBERT_SOLVES);
+    // if the solver didn't fail to converge, and it didn't hit the Earth
+    if (failed)
+    {
+        STAT_INC(STAT_LAMBERT_FAILURES);
+        return INF;
+    }
+
+    if (hit_Earth(R_start, R_end, Vo, V))
+    {
+        STAT_INC(STAT_HIT_EARTH);
+        return INF;
+    }
+
+    return norm(Vo - V_start) + norm(V - V_end);
+}
+
+/**
+ * Find the cheapest transfer between two states, a given time apart.
+ * This is the inner loop of the wsp_astro problem, and of anything else
+ * that prices a leg of a tour.  It is a template over the Lambert solver
+ * strategy (see LambertSolver.h), so each solver gets its own copy.
+ * @param xfer the Lambert solver strategy to use.
+ * @param R_start position at departure.
+ * @param V_start velocity at departure, before the first burn.
+ * @param R_end position at arrival.
+ * @param V_end velocity at arrival, after the second burn (the target's).
+ * @param tof time of flight, canonical units.
+ * @return the best transfer; its dv is INF if every attempt failed.
+ */
+template <class Solver> Transfer
+best_transfer ( Solver& xfer, Vec3 R_start, Vec3 V_start,
+                Vec3 R_end, Vec3 V_end, double tof )
+{
+    Transfer best;
+    double bound;              // what no branch can possibly beat.
+    double dv_long, dv_short;  // longway and shortway deltaV's
+    int rev_limit;
+
+    best.dv = INF; // best.dv stores the best delta-V of all the attempts.
+    best.revs = 0;
+    best.longway = false;
+
+    // Set up the Lambert problem.
+    xfer.setup(R_start, R_end, tof);
+    bound = dv_bound(R_start, V_start, R_end, V_end);
+
+    /*
+     * Lambert's problem has FOUR solutions:
+     * 1. prograde, short-way
+     * 2. prograde, long-way
+     * 3. retrograde, short-way
+     * 4. retrograde, long-way
+     *
+     * The retrograde solutions are a huge delta-V penalty.
+     * So we just look at the long-way and short-way prograde transfers
+     * and pick whichever is best.
+     *
+     * foo.solve(false, n ) means SHORT WAY, n revs.
+     * foo.solve(true, n )  means LONG WAY, n revs.
+     */
+
+    // Look for single and multi-rev solutions.
+    // Don't bother trying more revs than is possible for the given TOF.
+    rev_limit = 1 + 2 * (int)(tof / M_PI);
+    for (int revs = 0; revs < rev_limit; revs++) // multirev kludge
+    {
+        // Once the best so far is as good as it gets, stop looking.
+        if (best.dv <= bound)
+        {
+            STAT_INC(STAT_BOUND_SKIPS);
+            break;
+        }
+
+        STAT_INC(STAT_REV_BRANCHES);
+
+        xfer.solve(false, revs);  // short-way
+        dv_short = leg_dv(xfer.isFailure(), xfer.getVo(), xfer.getV(),
+                          R_start, V_start, R_end, V_end);
+
+        xfer.solve(true, revs);   // long-way
+        dv_long = leg_dv(xfer.isFailure(), xfer.getVo(), xfer.getV(),
+                         R_start, V_start, R_end, V_end);
+
+        if (dv_short < best.dv)
+        {
+            best.dv = dv_short;
+            best.revs = revs;
+            best.longway = false;
+        }
+
+        if (dv_long < best.dv)
+        {
+            best.dv = dv_long;
+            best.revs = revs;
+            best.longway = true;
+        }
+    }
+
+    return best;
+}
+
+#endif /* _TRANSFER_H_ */
@@ -33,7 +33,9 @@
 #include <math.h>
 #include "Vec3.h"
 #include "Orbgnosis.h"
+#include "SolverStats.h"
 #include "Stumpff.h"
+#include "Timer.h"
 #include "ULambert.h"
 #include <iostream>
 
@@ -47,9 +49,13 @@ ULambert::ULambert( void ) :
         t( 0.0 ),
         Ro( 0.0, 0.0, 0.0 ),
         R( 0.0, 0.0, 0.0 ),
+        seed( 0.0 ),
+        seeded( false ),
         Vo( 0.0, 0.0, 0.0 ),
         V( 0.0, 0.0, 0.0 ),
-        failure( false )
+        psi( 0.0 ),
+        failure( false ),
+        iterations( 0 )
 {
     //cout << "ULambert constructor called with no args.\n";
 }
@@ -64,9 +70,13 @@ ULambert::ULambert( Vec3 r1in, Vec3 r2in, double tin ) :
         t( tin ),
         Ro( r1in ),
         R( r2in ),
+        seed( 0.0 ),
+        seeded( false ),
         Vo( 0.0, 0.0, 0.0 ),
         V( 0.0, 0.0, 0.0 ),
-        failure( false )
+        psi( 0.0 ),
+        failure( false ),
+        iterations( 0 )
 {
     // cout << "ULambert constructor called with 2 vectors and 1 time.\n";
 }
@@ -106,6 +116,26 @@ ULambert::sett ( double tin )
     t = tin;
 }
 
+/**
+ * Seeds the next zero-rev solutions with a first guess for psi, usually
+ * getPsi() of a nearby problem.  Multi-rev solutions ignore it.
+ */
+void
+ULambert::setSeed ( double psin )
+{
+    seed = psin;
+    seeded = true;
+}
+
+/**
+ * Drops the seed, so zero-rev solutions start from the whole range again.
+ */
+void
+ULambert::clearSeed ( void )
+{
+    seeded = false;
+}
+
 /**
  * Gets the initial velocity vector, Vo.
  * This is the velocity at the point Ro which satisfies the Lamberts problem.
@@ -135,6 +165,15 @@ ULambert::gett ( void )
     return t;
 }
 
+/**
+ * Gets psi of the last solution, to seed a nearby problem with.
+ */
+double
+ULambert::getPsi ( void )
+{
+    return psi;
+}
+
 /**
  * Returns true if failure is true, false if faluire is false.
  * This method is necessary because failure is private.
@@ -152,6 +191,15 @@ ULambert::isFailure( void )
     }
 }
 
+/**
+ * Gets the number of iterations used by the last solution.
+ */
+int
+ULambert::getIterations( void )
+{
+    return iterations;
+}
+
 /**
  * Solves Lamberts Problem using universal variables method.
  * Adapted from David Vallado's Ada implementation in "Fundamentals of
@@ -165,7 +213,10 @@ ULambert::universal ( const bool Lin, const int revs )
     const bool longway = Lin;
 
     /// The maximum number of iterations allowed.
-    const int NumIter = 40;
+    const int NumIter = ULAMBERT_MAXITER;
+
+    /// The first step out from a seed.
+    const double SeedStep = 0.05;
 
     int Loops;      //<! loop counter.
     int YNegKtr;    //<! counts how many times Y returned negative.
@@ -184,12 +235,21 @@ ULambert::universal ( const bool Lin, const int revs )
     double C2New;   //<! Locally stored value of the C2 Stumpff function.
     double C3New;   //<! Locally stored value of the C3 Stumpff function.
     double dtNew;   //<! delta-T from Algoritm #55.
+    double Step;    //<! next step out from the seed, 0 once bracketed.
+    double SeedDir = 0.0; //<! which way the first step from the seed went.
 
 
     double Ro4; //<! magnitude of the Vec3 Ro.  The naming convention traces back to Vallado's Ada version which used the 4th element of an array to hold the vector norm of the first 3 elements.
     double R4;  //<! magnitude of the Vec3 R.
 
+    SolverStats* stats = solver_stats;  //<! this thread's statistics, if any.
+    double start_time = ( NULL != stats ) ? wall_time() : 0.0;
+    int corrections = 0;    //<! times the Y-negative correction ran.
+    solver_failure why = FAIL_NONE;
+
     failure = false;
+    iterations = 0;
+    psi = 0.0;
 
     PsiNew = 0.0;
     Vo.toZero();
@@ -235,6 +295,17 @@ ULambert::universal ( const bool Lin, const int revs )
         Lower = SMALL + 4.0 * (0.5 * revs) * (0.5 * revs) * M_PI * M_PI;
     }
 
+    // A zero-rev seed inside the bounds replaces the first guess.
+    Step = 0.0;
+
+    if ( seeded && ( 0 == revs ) && ( seed > Lower ) && ( seed < Upper ) )
+    {
+        PsiOld = seed;
+        C2New = stumpff_C2( PsiOld );
+        C3New = stumpff_C3( PsiOld );
+        Step = SeedStep;
+    }
+
     // Determine if the orbit is possible at all
     if ( fabs( VarA ) > SMALL )
     {
@@ -242,7 +313,11 @@ ULambert::universal ( const bool Lin, const int revs )
         YNegKtr = 1;  // y neg counter
         dtNew = -10.0;
 
-        while ( ( fabs( dtNew - t ) > SMALL ) && ( NumIter > Loops ) )
+        // Give up once the Y correction runs out of tries; carrying on
+        // would only retry the same psi, for ever if Y came good on the
+        // last try.
+        while ( ( fabs( dtNew - t ) > SMALL ) && ( NumIter > Loops )
+                && ( 10 > YNegKtr ) )
         {
             if ( fabs( C2New ) > SMALL )
             {
@@ -269,6 +344,7 @@ ULambert::universal ( const bool Lin, const int revs )
                     C3New = stumpff_C3( PsiNew );
                     PsiOld = PsiNew;
                     Lower = PsiOld;
+                    Step = 0.0;
 
                     if ( fabs( C2New ) > SMALL )
                     {
@@ -282,6 +358,7 @@ ULambert::universal ( const bool Lin, const int revs )
                     }
 
                     YNegKtr = YNegKtr + 1;
+                    corrections++;
                 } // end while loop.
             } // end if Y neg.
 
@@ -299,6 +376,7 @@ ULambert::universal ( const bool Lin, const int revs )
 
                 XOldCubed = XOld * XOld * XOld;
                 dtNew = XOldCubed * C3New + VarA * sqrt( Y );
+                psi = PsiOld;
 
                 // Readjust upper and lower bounds.
 
@@ -312,7 +390,31 @@ ULambert::universal ( const bool Lin, const int revs )
                     Upper = PsiOld;
                 }
 
-                PsiNew = ( Upper + Lower ) * 0.5;
+                if ( 0.0 < Step )
+                {
+                    // Step out from the seed, twice as far each time,
+                    // until the answer is bracketed.
+                    double dir = ( dtNew < t ) ? 1.0 : -1.0;
+
+                    if ( 0.0 == SeedDir )
+                    {
+                        SeedDir = dir;
+                    }
+
+                    PsiNew = PsiOld + dir * Step;
+                    Step = 2.0 * Step;
+
+                    if ( ( dir != SeedDir ) || ( PsiNew <= Lower ) || ( PsiNew >= Upper ) )
+                    {
+                        Step = 0.0;
+                        PsiNew = ( Upper + Lower ) * 0.5;
+                    }
+                }
+
+                else
+                {
+                    PsiNew = ( Upper + Lower ) * 0.5;
+                }
 
                 // Find C2 and C3 functions.
                 C2New = stumpff_C2( PsiNew );
@@ -339,14 +441,17 @@ ULambert::universal ( const bool Lin, const int revs )
             } // end if (10 > YNegKtr)
         } // end while loop
 
-        if ( ( Loops >= NumIter ) || ( YNegKtr > 10 ) )
+        iterations = Loops;
+
+        if ( ( Loops >= NumIter ) || ( YNegKtr >= 10 ) )
         {
             // cout << "Error: Lambert Universal failed to converge. \n";
-            //if (YNegKtr > 10) cout << "Y is negative\n";
+            //if (YNegKtr >= 10) cout << "Y is negative\n";
             //cout << "NmIter = " << NumIter << "\n";
             Vo.toInf();
             V.toInf();
             failure = true;
+            why = ( YNegKtr >= 10 ) ? FAIL_Y_NEGATIVE : FAIL_ITERATION_LIMIT;
         }
 
         else
@@ -368,8 +473,17 @@ ULambert::universal ( const bool Lin, const int revs )
         Vo.toInf();
         V.toInf();
         failure = true;
+        why = FAIL_180_DEGREES;
     } // end if VarA > SMALL
 
+    if ( NULL != stats )
+    {
+        stats->lambert_call( ( PsiNew > SMALL ) ? REGIME_ELLIPTIC
+                             : ( PsiNew < -SMALL ) ? REGIME_HYPERBOLIC
+                             : REGIME_PARABOLIC,
+                             wall_time() - start_time, iterations, why, corrections );
+    }
+
     /* Convert from canonical units back to S.I.
         Vo = Vo * ER / TU_SEC;
         V = V * ER / TU_SEC;
@@ -41,6 +41,11 @@
  * and is only slightly slower.  The upper and lower bounds are set accordingly
  * so that the solution converges to the desired solution, but only the
  * zero-revolution case(s) are garuanteed.
+ *
+ * A zero-rev solve may be seeded with the psi of a nearby solution (a
+ * neighboring cell of a porkchop grid, say).  The search then steps out
+ * from the seed until it brackets the answer, and bisects only that,
+ * which takes far fewer iterations than bisecting the whole range.
  */
 
 class ULambert
@@ -54,7 +59,7 @@ class ULambert
                    Vec3 r2in,        //!< final position
                    double tin ); //!< time of flight.
 
-        virtual ~ULambert ( void );
+        ~ULambert ( void );
 
         // Universal Variable method
         void universal( const bool, const int );
@@ -62,12 +67,16 @@ class ULambert
         void setRo ( Vec3 );
         void setR ( Vec3 );
         void sett ( double );
+        void setSeed ( double );    // zero-rev first guess for psi
+        void clearSeed ( void );    // ... back to a cold start
 
         Vec3 getVo ( void );
         Vec3 getV ( void );
         double gett ( void );
+        double getPsi ( void );
 
         bool isFailure( void );
+        int getIterations( void );
 
     private:
 
@@ -75,12 +84,16 @@ class ULambert
         double t;   //!< specified time of flight from Ro to R.
         Vec3 Ro;  //!< initial position vector.
         Vec3 R;   //!< final position vector.
+        double seed;    //!< first guess for psi, zero-rev only.
+        bool seeded;    //!< is seed set?
 
         // Results:
         Vec3 Vo;  //!< initial velocity of at start of the transfer arc.
         Vec3 V;   //!< final velocity at the end of transfer arc.
 
+        double psi;     //!< psi of the last solution.
         bool failure;   //!< is true if the solution fails to converge.
+        int iterations; //!< iterations used by the last solution.
 };
 
 #endif /* _ULAMBERT_H_ */
@@ -35,223 +35,6 @@
 
 using namespace std;
 
-/**
- * The Vec3 constructor with no arguments defaults to all zeroes.
- */
-Vec3::Vec3 ( void )
-{
-    for ( int i = 0; i < 3; i++ )
-        e[ i ] = 0.0;
-
-    // cout << "Default Vec3 constructor called.\n";
-}
-
-/**
- * The Vec3 constructor takes three doubles, the vector elements.
- * @param xin is the first element.
- * @param yin is the second element.
- * @param zin is the third element.
- */
-Vec3::Vec3 ( double xin, double yin, double zin )
-{
-    e[ 0 ] = xin;
-    e[ 1 ] = yin;
-    e[ 2 ] = zin;
-    // cout << "3-arg Vec3 constructor called.\n";
-}
-
-/**
- * The Vec3 destructor.
- */
-Vec3::~Vec3 ( void )
-{
-    //cout << "Vec3 dtor.\n";
-}
-
-/**
- * The Vec3 copy constructor.
- * @param copy is a reference to the Vec3 to be copied.
- */
-Vec3::Vec3 ( const Vec3& copy )
-{
-    for ( int i = 0; i < 3; i++ )
-        e[ i ] = copy.e[ i ];
-
-    //cout << "Vec3 copy constructor called\n";
-}
-
-/**
- * The Vec3 copy assignment operator.
- */
-Vec3&
-Vec3::operator = ( const Vec3& q )
-{
-    if ( this != &q )  // avoid pointless self-assignment
-    {
-
-        for ( int i = 0; i < 3; i++ )
-            e[ i ] = q.e[ i ];
-    }
-
-    return *this;
-}
-
-/**
- * The Vec3 addition-assignment operator.
- */
-Vec3&
-Vec3::operator += ( const Vec3& q )
-{
-    for ( int i = 0; i < 3; i++ )
-        e[ i ] += q.e[ i ];
-
-    return *this;
-}
-
-/**
- * The Vec3 addition-assignment operator.
- */
-Vec3&
-Vec3::operator -= ( const Vec3& q )
-{
-    for ( int i = 0; i < 3; i++ )
-        e[ i ] -= q.e[ i ];
-
-    return *this;
-}
-
-/**
- * Multiplies a Vec3 with a scalar of type double and returns a Vec3.
- * @param q is a vector (type must be Vec3).
- * @param s is a scalar (type must be double).
- */
-Vec3
-operator * ( const Vec3& q, const double& s )
-{
-    return Vec3 ( q.e[ 0 ] * s,
-                  q.e[ 1 ] * s,
-                  q.e[ 2 ] * s );
-}
-
-/**
- * Multiplies a scalar of type double with a Vec3 and returns a Vec3.
- * @param s is a scalar (type must be double).
- * @param q is a vector (type must be Vec3).
- */
-Vec3
-operator * ( const double& s, const Vec3& q )
-{
-    return Vec3 ( q.e[ 0 ] * s,
-                  q.e[ 1 ] * s,
-                  q.e[ 2 ] * s );
-}
-
-/**
- * Divides a Vec3 by a scalar of type double and returns a Vec3.
- * @param q is a vector (type must be Vec3).
- * @param s is a scalar (type must be double).
- */
-Vec3
-operator / ( const Vec3& q, const double& s )
-{
-    return Vec3 ( q.e[ 0 ] / s,
-                  q.e[ 1 ] / s,
-                  q.e[ 2 ] / s );
-}
-
-/**
- * Divides scalar of type double by a Vec3 and returns a Vec3.
- * @param s is a scalar (type must be double).
- * @param q is a vector (type must be Vec3).
- */
-Vec3
-operator / ( const double& s, const Vec3& q )
-{
-    return Vec3 ( s / q.e[ 0 ],
-                  s / q.e[ 1 ],
-                  s / q.e[ 2 ] );
-}
-
-/**
- * Vec3 addition.
- * @param a is a constant reference to the first Vec3.
- * @param b is a constant reference to the second Vec3.
- */
-Vec3
-operator + ( const Vec3& a, const Vec3& b )
-{
-    return Vec3 ( a.e[ 0 ] + b.e[ 0 ],
-                  a.e[ 1 ] + b.e[ 1 ],
-                  a.e[ 2 ] + b.e[ 2 ] );
-}
-
-/**
- * Vec3 unary addition.
- * example: a = + b; 
- */
-Vec3
-operator + ( const Vec3& a )
-{
-    return a;
-}
-
-/**
- * Vec3 subtraction.
- * @param a is a constant reference to the first Vec3.
- * @param b is a constant reference to the second Vec3.
- */
-Vec3
-operator - ( const Vec3& a, const Vec3& b )
-{
-    return Vec3 ( a.e[ 0 ] - b.e[ 0 ],
-                  a.e[ 1 ] - b.e[ 1 ],
-                  a.e[ 2 ] - b.e[ 2 ] );
-}
-
-/**
- * Vec3 unary subtraction.
- */
-Vec3
-operator - ( const Vec3& a )
-{
-    return Vec3() - a;  // 0 - a = -a
-}
-
-/**
- * Cross product, returns type Vec3.
- * @param a is a constant reference to the first Vec3.
- * @param b is a constant reference to the second Vec3.
- */
-Vec3
-cross ( const Vec3& a, const Vec3& b )
-{
-    const double x = a.e[ 1 ] * b.e[ 2 ] - a.e[ 2 ] * b.e[ 1 ];
-    const double y = a.e[ 2 ] * b.e[ 0 ] - a.e[ 0 ] * b.e[ 2 ];
-    const double z = a.e[ 0 ] * b.e[ 1 ] - a.e[ 1 ] * b.e[ 0 ];
-    return Vec3( x, y, z );
-}
-
-/**
- * Dot product, returns type double.
- * @param a is a constant reference to the first Vec3.
- * @param b is a constant reference to the second Vec3.
- */
-double
-dot ( const Vec3& a, const Vec3& b )
-{
-    return ( a.e[ 0 ] * b.e[ 0 ] ) + ( a.e[ 1 ] * b.e[ 1 ] ) + ( a.e[ 2 ] * b.e[ 2 ] );
-}
-
-/**
- * The Euclidean vector norm.
- * @param q is a constant reference to a Vec3.
- */
-double
-norm ( const Vec3& q )
-{
-    return sqrt ( q.e[ 0 ] * q.e[ 0 ] + q.e[ 1 ] * q.e[ 1 ] + q.e[ 2 ] * q.e[ 2 ] );
-}
-
 /**
  * The iostream output operator is overloaded for the Vec3 type.
  * @param s is a reference to ostream.
@@ -31,6 +31,7 @@
 #ifndef _VEC3_H_
 #define _VEC3_H_
 #include <iostream>
+#include <math.h>
 
 using namespace std;
 
@@ -49,11 +50,9 @@ class Vec3
         Vec3 ( void );          // defaults to (0,0,0).
         Vec3 ( double, double, double );
 
-        virtual ~Vec3 ( void );
-
-        Vec3 ( const Vec3& );   // copy constructor
-
-        Vec3& operator = ( const Vec3& );
+        // No destructor, copy constructor or assignment operator: the
+        // implicit ones copy three doubles, and leave Vec3 without a
+        // vtable, so it is trivially copyable.
 
         Vec3& operator += ( const Vec3& ); // add-assign
         Vec3& operator -= ( const Vec3& ); // subtract-assign
@@ -100,4 +99,185 @@ class Vec3
         double e[ 3 ];  // elements of the vector.
 };
 
+/**
+ * The Vec3 constructor with no arguments defaults to all zeroes.
+ */
+inline Vec3::Vec3 ( void )
+{
+    for ( int i = 0; i < 3; i++ )
+        e[ i ] = 0.0;
+
+    // cout << "Default Vec3 constructor called.\n";
+}
+
+/**
+ * The Vec3 constructor takes three doubles, the vector elements.
+ * @param xin is the first element.
+ * @param yin is the second element.
+ * @param zin is the third element.
+ */
+inline Vec3::Vec3 ( double xin, double yin, double zin )
+{
+    e[ 0 ] = xin;
+    e[ 1 ] = yin;
+    e[ 2 ] = zin;
+    // cout << "3-arg Vec3 constructor called.\n";
+}
+
+/**
+ * The Vec3 addition-assignment operator.
+ */
+inline Vec3&
+Vec3::operator += ( const Vec3& q )
+{
+    for ( int i = 0; i < 3; i++ )
+        e[ i ] += q.e[ i ];
+
+    return *this;
+}
+
+/**
+ * The Vec3 addition-assignment operator.
+ */
+inline Vec3&
+Vec3::operator -= ( const Vec3& q )
+{
+    for ( int i = 0; i < 3; i++ )
+        e[ i ] -= q.e[ i ];
+
+    return *this;
+}
+
+/**
+ * Multiplies a Vec3 with a scalar of type double and returns a Vec3.
+ * @param q is a vector (type must be Vec3).
+ * @param s is a scalar (type must be double).
+ */
+inline Vec3
+operator * ( const Vec3& q, const double& s )
+{
+    return Vec3 ( q.e[ 0 ] * s,
+                  q.e[ 1 ] * s,
+                  q.e[ 2 ] * s );
+}
+
+/**
+ * Multiplies a scalar of type double with a Vec3 and returns a Vec3.
+ * @param s is a scalar (type must be double).
+ * @param q is a vector (type must be Vec3).
+ */
+inline Vec3
+operator * ( const double& s, const Vec3& q )
+{
+    return Vec3 ( q.e[ 0 ] * s,
+                  q.e[ 1 ] * s,
+                  q.e[ 2 ] * s );
+}
+
+/**
+ * Divides a Vec3 by a scalar of type double and returns a Vec3.
+ * @param q is a vector (type must be Vec3).
+ * @param s is a scalar (type must be double).
+ */
+inline Vec3
+operator / ( const Vec3& q, const double& s )
+{
+    return Vec3 ( q.e[ 0 ] / s,
+                  q.e[ 1 ] / s,
+                  q.e[ 2 ] / s );
+}
+
+/**
+ * Divides scalar of type double by a Vec3 and returns a Vec3.
+ * @param s is a scalar (type must be double).
+ * @param q is a vector (type must be Vec3).
+ */
+inline Vec3
+operator / ( const double& s, const Vec3& q )
+{
+    return Vec3 ( s / q.e[ 0 ],
+                  s / q.e[ 1 ],
+                  s / q.e[ 2 ] );
+}
+
+/**
+ * Vec3 addition.
+ * @param a is a constant reference to the first Vec3.
+ * @param b is a constant reference to the second Vec3.
+ */
+inline Vec3
+operator + ( const Vec3& a, const Vec3& b )
+{
+    return Vec3 ( a.e[ 0 ] + b.e[ 0 ],
+                  a.e[ 1 ] + b.e[ 1 ],
+                  a.e[ 2 ] + b.e[ 2 ] );
+}
+
+/**
+ * Vec3 unary addition.
+ * example: a = + b; 
+ */
+inline Vec3
+operator + ( const Vec3& a )
+{
+    return a;
+}
+
+/**
+ * Vec3 subtraction.
+ * @param a is a constant reference to the first Vec3.
+ * @param b is a constant reference to the second Vec3.
+ */
+inline Vec3
+operator - ( const Vec3& a, const Vec3& b )
+{
+    return Vec3 ( a.e[ 0 ] - b.e[ 0 ],
+                  a.e[ 1 ] - b.e[ 1 ],
+                  a.e[ 2 ] - b.e[ 2 ] );
+}
+
+/**
+ * Vec3 unary subtraction.
+ */
+inline Vec3
+operator - ( const Vec3& a )
+{
+    return Vec3() - a;  // 0 - a = -a
+}
+
+/**
+ * Cross product, returns type Vec3.
+ * @param a is a constant reference to the first Vec3.
+ * @param b is a constant reference to the second Vec3.
+ */
+inline Vec3
+cross ( const Vec3& a, const Vec3& b )
+{
+    const double x = a.e[ 1 ] * b.e[ 2 ] - a.e[ 2 ] * b.e[ 1 ];
+    const double y = a.e[ 2 ] * b.e[ 0 ] - a.e[ 0 ] * b.e[ 2 ];
+    const double z = a.e[ 0 ] * b.e[ 1 ] - a.e[ 1 ] * b.e[ 0 ];
+    return Vec3( x, y, z );
+}
+
+/**
+ * Dot product, returns type double.
+ * @param a is a constant reference to the first Vec3.
+ * @param b is a constant reference to the second Vec3.
+ */
+inline double
+dot ( const Vec3& a, const Vec3& b )
+{
+    return ( a.e[ 0 ] * b.e[ 0 ] ) + ( a.e[ 1 ] * b.e[ 1 ] ) + ( a.e[ 2 ] * b.e[ 2 ] );
+}
+
+/**
+ * The Euclidean vector norm.
+ * @param q is a constant reference to a Vec3.
+ */
+inline double
+norm ( const Vec3& q )
+{
+    return sqrt ( q.e[ 0 ] * q.e[ 0 ] + q.e[ 1 ] * q.e[ 1 ] + q.e[ 2 ] * q.e[ 2 ] );
+}
+
 #endif /* _VEC3_H_ */
@@ -65,6 +65,11 @@ void allocate_memory_ind (individual *ind)
         }
     }
 
+    if (nperm != 0)
+    {
+        ind->perm = (int *)malloc(nperm * sizeof(int));
+    }
+
     ind->obj = (double *)malloc(nobj * sizeof(double));
 
     if (ncon != 0)
@@ -110,6 +115,11 @@ void deallocate_memory_ind (individual *ind)
         free(ind->gene);
     }
 
+    if (nperm != 0)
+    {
+        free(ind->perm);
+    }
+
     free(ind->obj);
 
     if (ncon != 0)
@@ -36,6 +36,84 @@ void crossover (individual *parent1, individual *parent2, individual *child1, in
 {
     if (nreal != 0) realcross (parent1, parent2, child1, child2);
     if (nbin != 0) bincross (parent1, parent2, child1, child2);
+    if (nperm != 0) permcross (parent1, parent2, child1, child2);
+    inherit_evaluation (child1, parent1, parent2);
+    inherit_evaluation (child2, parent1, parent2);
+    return ;
+}
+
+/* Routine to check whether two individuals have identical chromosomes */
+int same_chromosome (individual *ind1, individual *ind2)
+{
+    int i, j;
+
+    for (i = 0; i < nreal; i++)
+    {
+        if (ind1->xreal[i] != ind2->xreal[i])
+        {
+            return (0);
+        }
+    }
+
+    for (i = 0; i < nbin; i++)
+    {
+        for (j = 0; j < nbits[i]; j++)
+        {
+            if (ind1->gene[i][j] != ind2->gene[i][j])
+            {
+                return (0);
+            }
+        }
+    }
+
+    for (i = 0; i < nperm; i++)
+    {
+        if (ind1->perm[i] != ind2->perm[i])
+        {
+            return (0);
+        }
+    }
+
+    return (1);
+}
+
+/* Routine to give a child which crossover left identical to a parent that
+   parent's objectives and constraints, so it needn't be evaluated again.
+   A pruned parent's objectives are only bounds, so they aren't passed on */
+void inherit_evaluation (individual *child, individual *parent1, individual *parent2)
+{
+    individual *parent = NULL;
+    int i;
+    child->evaluated = 0;
+    child->pruned = 0;
+
+    if (parent1->evaluated && !parent1->pruned && same_chromosome (child, parent1))
+    {
+        parent = parent1;
+    }
+
+    else if (parent2->evaluated && !parent2->pruned && same_chromosome (child, parent2))
+    {
+        parent = parent2;
+    }
+
+    if (parent == NULL)
+    {
+        return ;
+    }
+
+    for (i = 0; i < nobj; i++)
+    {
+        child->obj[i] = parent->obj[i];
+    }
+
+    for (i = 0; i < ncon; i++)
+    {
+        child->constr[i] = parent->constr[i];
+    }
+
+    child->constr_violation = parent->constr_violation;
+    child->evaluated = 1;
     return ;
 }
 
@@ -209,3 +287,118 @@ void bincross (individual *parent1, individual *parent2, individual *child1, ind
 
     return ;
 }
+
+/* Routine for permutation crossover, either order crossover (OX) or partially mapped crossover (PMX) */
+void permcross (individual *parent1, individual *parent2, individual *child1, individual *child2)
+{
+    int i;
+    int temp, site1, site2;
+    int *work = perm_work;  /* allocated once, in main() */
+
+    if (randomperc() <= pcross_perm)
+    {
+        npermcross++;
+        site1 = rnd(0, nperm - 1);
+        site2 = rnd(0, nperm - 1);
+
+        if (site1 > site2)
+        {
+            temp = site1;
+            site1 = site2;
+            site2 = temp;
+        }
+
+        if (perm_cross_type == 1)
+        {
+            pmx_cross (parent1->perm, parent2->perm, child1->perm, site1, site2, work);
+            pmx_cross (parent2->perm, parent1->perm, child2->perm, site1, site2, work);
+        }
+
+        else
+        {
+            ox_cross (parent1->perm, parent2->perm, child1->perm, site1, site2, work);
+            ox_cross (parent2->perm, parent1->perm, child2->perm, site1, site2, work);
+        }
+    }
+
+    else
+    {
+        for (i = 0; i < nperm; i++)
+        {
+            child1->perm[i] = parent1->perm[i];
+            child2->perm[i] = parent2->perm[i];
+        }
+    }
+
+    return ;
+}
+
+/* Order crossover: the child keeps p1[site1..site2] in place, and the remaining positions,
+   starting after site2 and wrapping around, get the other elements in the order they appear in p2 */
+void ox_cross (int *p1, int *p2, int *c, int site1, int site2, int *used)
+{
+    int i, j, k;
+
+    for (i = 0; i < nperm; i++)
+    {
+        used[i] = 0;
+    }
+
+    for (i = site1; i <= site2; i++)
+    {
+        c[i] = p1[i];
+        used[p1[i]] = 1;
+    }
+
+    k = (site2 + 1) % nperm;
+
+    for (i = 0; i < nperm; i++)
+    {
+        j = p2[(site2 + 1 + i) % nperm];
+
+        if (!used[j])
+        {
+            c[k] = j;
+            k = (k + 1) % nperm;
+        }
+    }
+
+    return ;
+}
+
+/* Partially mapped crossover: the child keeps p1[site1..site2] in place and takes the rest
+   from p2, following the segment's mapping p1[k] -> p2[k] wherever p2 repeats a segment element */
+void pmx_cross (int *p1, int *p2, int *c, int site1, int site2, int *pos)
+{
+    int i, j;
+
+    for (i = 0; i < nperm; i++)
+    {
+        pos[i] = -1;
+    }
+
+    for (i = site1; i <= site2; i++)
+    {
+        c[i] = p1[i];
+        pos[p1[i]] = i;
+    }
+
+    for (i = 0; i < nperm; i++)
+    {
+        if (i >= site1 && i <= site2)
+        {
+            continue;
+        }
+
+        j = p2[i];
+
+        while (pos[j] >= 0)
+        {
+            j = p2[pos[j]];
+        }
+
+        c[i] = j;
+    }
+
+    return ;
+}
@@ -66,7 +66,7 @@ void onthefly_display (population *pop, FILE *gp, int ii)
     {
         if (choice != 3)
         {
-            fprintf(gp, "set title 'Non-dominated solutions. %d targets. Generation #%d'\n unset key\n plot 'plot.out' w points pointtype 6 pointsize 1\n", TARGETS, ii);
+            fprintf(gp, "set title 'Non-dominated solutions. %d targets. Generation #%d'\n unset key\n plot 'plot.out' w points pointtype 6 pointsize 1\n", targets, ii);
             fprintf(gp, "set xlabel 'Time of Flight (minutes)'\n");
             fprintf(gp, "set ylabel 'Total delta-V (m/sec)'\n");
         }
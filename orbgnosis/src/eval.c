@@ -30,7 +30,10 @@
 # include "global.h"
 # include "rand.h"
 
+# include "EvalMemo.h"
 # include "Graph.h"
+# include "LegTrie.h"
+# include "RunStats.h"
 # include "Tour.h"
 
 /* Routine to evaluate objective function values and constraints for a population */
@@ -38,8 +41,23 @@ void evaluate_pop (population *pop)
 {
     int i;
 
+    /* Legs are only shared within one population */
+    if (leg_trie != NULL)
+    {
+        leg_trie->clear();
+    }
+
     for (i = 0; i < popsize; i++)
     {
+        /* Children untouched by crossover and mutation already have their
+           parent's objectives */
+        if (eval_memo != NULL && pop->ind[i].evaluated)
+        {
+            nuntouched++;
+            STAT_INC(STAT_UNTOUCHED);
+            continue;
+        }
+
         evaluate_ind (&(pop->ind[i]));
     }
 
@@ -50,7 +68,30 @@ void evaluate_pop (population *pop)
 void evaluate_ind (individual *ind)
 {
     int j;
-    test_problem (ind->xreal, ind->xbin, ind->gene, ind->obj, ind->constr);
+
+    /* A chromosome seen before is copied from the memo */
+    if (eval_memo != NULL
+        && eval_memo->find (ind->xreal, ind->gene, ind->perm, ind->obj, ind->constr))
+    {
+        STAT_INC(STAT_MEMO_HITS);
+        ind->pruned = 0;    /* pruned tours are never memoized */
+    }
+
+    else
+    {
+        eval_pruned = 0;
+        STAT_WATCH_ALLOCS(test_problem (ind->xreal, ind->xbin, ind->gene, ind->perm, ind->obj, ind->constr));
+        STAT_INC(STAT_EVALUATIONS);
+        ind->pruned = eval_pruned;
+
+        /* A pruned tour's objectives depend on the front it was pruned by */
+        if (eval_memo != NULL && !eval_pruned)
+        {
+            eval_memo->insert (ind->xreal, ind->gene, ind->perm, ind->obj, ind->constr);
+        }
+    }
+
+    ind->evaluated = 1;
 
     if (ncon == 0)
     {
@@ -68,6 +109,31 @@ void evaluate_ind (individual *ind)
                 ind->constr_violation += ind->constr[j];
             }
         }
+
+        if (ind->constr_violation < 0.0)
+        {
+            STAT_INC(STAT_INFEASIBLE);
+        }
+    }
+
+    return ;
+}
+
+/* Routine to copy the objectives of the feasible first front of a population
+   into bound_front, for test_problem to prune against */
+void set_front_bound (population *pop)
+{
+    int i;
+    front_size = 0;
+
+    for (i = 0; i < popsize; i++)
+    {
+        if (pop->ind[i].rank == 1 && pop->ind[i].constr_violation == 0.0)
+        {
+            bound_front[2 * front_size] = pop->ind[i].obj[0];
+            bound_front[2 * front_size + 1] = pop->ind[i].obj[1];
+            front_size++;
+        }
     }
 
     return ;
@@ -43,9 +43,12 @@ typedef struct /* individual */
     double *xreal;
     int **gene;
     double *xbin;
+    int *perm;
     double *obj;
     double *constr;
     double crowd_dist;
+    int evaluated;      /* 1 if obj and constr belong to the genes */
+    int pruned;         /* 1 if test_problem gave up on it early */
 }
 
 individual;
@@ -84,6 +87,13 @@ extern int nbinmut;
 extern int nrealmut;
 extern int nbincross;
 extern int nrealcross;
+extern int nperm;
+extern double pcross_perm;
+extern double pmut_perm;
+extern int perm_cross_type;
+extern int npermcross;
+extern int npermmut;
+extern int *perm_work;
 extern int *nbits;
 extern double *min_realvar;
 extern double *max_realvar;
@@ -96,6 +106,14 @@ extern int obj2;
 extern int obj3;
 extern int angle1;
 extern int angle2;
+extern int prune;
+extern int front_size;
+extern double *bound_front;
+extern int share;
+extern int memo;
+extern double memo_quantum;
+extern int eval_pruned;
+extern int nuntouched;
 
 void allocate_memory_pop (population *pop, int size);
 void allocate_memory_ind (individual *ind);
@@ -108,6 +126,11 @@ double minimum (double a, double b);
 void crossover (individual *parent1, individual *parent2, individual *child1, individual *child2);
 void realcross (individual *parent1, individual *parent2, individual *child1, individual *child2);
 void bincross (individual *parent1, individual *parent2, individual *child1, individual *child2);
+void permcross (individual *parent1, individual *parent2, individual *child1, individual *child2);
+int same_chromosome (individual *ind1, individual *ind2);
+void inherit_evaluation (individual *child, individual *parent1, individual *parent2);
+void ox_cross (int *p1, int *p2, int *c, int site1, int site2, int *used);
+void pmx_cross (int *p1, int *p2, int *c, int site1, int site2, int *pos);
 
 void assign_crowding_distance_list (population *pop, list *lst, int front_size);
 void assign_crowding_distance_indices (population *pop, int c1, int c2);
@@ -122,6 +145,7 @@ int check_dominance (individual *a, individual *b);
 
 void evaluate_pop (population *pop);
 void evaluate_ind (individual *ind);
+void set_front_bound (population *pop);
 
 void fill_nondominated_sort (population *mixed_pop, population *new_pop);
 void crowding_fill (population *mixed_pop, population *new_pop, int count, int front_size, list *cur);
@@ -139,8 +163,9 @@ void mutation_pop (population *pop);
 void mutation_ind (individual *ind);
 void bin_mutate_ind (individual *ind);
 void real_mutate_ind (individual *ind);
+void perm_mutate_ind (individual *ind);
 
-void test_problem (double *xreal, double *xbin, int **gene, double *obj, double *constr);
+void test_problem (double *xreal, double *xbin, int **gene, int *perm, double *obj, double *constr);
 
 void assign_rank_and_crowding_distance (population *new_pop);
 
@@ -46,7 +46,7 @@ void initialize_pop (population *pop)
 /* Function to initialize an individual randomly */
 void initialize_ind (individual *ind)
 {
-    int j, k;
+    int j, k, temp;
 
     if (nreal != 0)
     {
@@ -75,5 +75,24 @@ void initialize_ind (individual *ind)
         }
     }
 
+    if (nperm != 0)
+    {
+        /* Random shuffle of 0 ... nperm-1 */
+        for (j = 0; j < nperm; j++)
+        {
+            ind->perm[j] = j;
+        }
+
+        for (j = 0; j < nperm - 1; j++)
+        {
+            k = rnd (j, nperm - 1);
+            temp = ind->perm[k];
+            ind->perm[k] = ind->perm[j];
+            ind->perm[j] = temp;
+        }
+    }
+
+    ind->evaluated = 0;
+    ind->pruned = 0;
     return ;
 }
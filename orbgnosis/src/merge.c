@@ -55,6 +55,8 @@ void copy_ind (individual *ind1, individual *ind2)
     ind2->rank = ind1->rank;
     ind2->constr_violation = ind1->constr_violation;
     ind2->crowd_dist = ind1->crowd_dist;
+    ind2->evaluated = ind1->evaluated;
+    ind2->pruned = ind1->pruned;
 
     if (nreal != 0)
     {
@@ -77,6 +79,14 @@ void copy_ind (individual *ind1, individual *ind2)
         }
     }
 
+    if (nperm != 0)
+    {
+        for (i = 0; i < nperm; i++)
+        {
+            ind2->perm[i] = ind1->perm[i];
+        }
+    }
+
     for (i = 0; i < nobj; i++)
     {
         ind2->obj[i] = ind1->obj[i];
@@ -46,6 +46,8 @@ void mutation_pop (population *pop)
 /* Function to perform mutation of an individual */
 void mutation_ind (individual *ind)
 {
+    int mutations = nrealmut + nbinmut + npermmut;
+
     if (nreal != 0)
     {
         real_mutate_ind(ind);
@@ -56,6 +58,16 @@ void mutation_ind (individual *ind)
         bin_mutate_ind(ind);
     }
 
+    if (nperm != 0)
+    {
+        perm_mutate_ind(ind);
+    }
+
+    if (nrealmut + nbinmut + npermmut != mutations)
+    {
+        ind->evaluated = 0;
+    }
+
     return ;
 }
 
@@ -140,3 +152,50 @@ void real_mutate_ind (individual *ind)
 
     return ;
 }
+
+/* Routine for permutation mutation of an individual, either a swap of two elements or
+   moving one element to another position (insert), with equal probability */
+void perm_mutate_ind (individual *ind)
+{
+    int j, k, i, temp;
+
+    if (nperm > 1 && randomperc() <= pmut_perm)
+    {
+        j = rnd (0, nperm - 1);
+        k = rnd (0, nperm - 1);
+
+        if (randomperc() <= 0.5)
+        {
+            temp = ind->perm[j];
+            ind->perm[j] = ind->perm[k];
+            ind->perm[k] = temp;
+        }
+
+        else
+        {
+            temp = ind->perm[j];
+
+            if (j < k)
+            {
+                for (i = j; i < k; i++)
+                {
+                    ind->perm[i] = ind->perm[i + 1];
+                }
+            }
+
+            else
+            {
+                for (i = j; i > k; i--)
+                {
+                    ind->perm[i] = ind->perm[i - 1];
+                }
+            }
+
+            ind->perm[k] = temp;
+        }
+
+        npermmut += 1;
+    }
+
+    return ;
+}
@@ -69,6 +69,14 @@ void report_pop (population *pop, FILE *fpt)
             }
         }
 
+        if (nperm != 0)
+        {
+            for (j = 0; j < nperm; j++)
+            {
+                fprintf(fpt, "%d\t", pop->ind[i].perm[j]);
+            }
+        }
+
         fprintf(fpt, "%e\t", pop->ind[i].constr_violation);
         fprintf(fpt, "%d\t", pop->ind[i].rank);
         fprintf(fpt, "%e\n", pop->ind[i].crowd_dist);
@@ -84,7 +92,8 @@ void report_feasible (population *pop, FILE *fpt)
 
     for (i = 0; i < popsize; i++)
     {
-        if (pop->ind[i].constr_violation == 0.0 && pop->ind[i].rank == 1)
+        if (pop->ind[i].constr_violation == 0.0 && pop->ind[i].rank == 1
+            && !pop->ind[i].pruned)
         {
             for (j = 0; j < nobj; j++)
             {
@@ -118,6 +127,14 @@ void report_feasible (population *pop, FILE *fpt)
                 }
             }
 
+            if (nperm != 0)
+            {
+                for (j = 0; j < nperm; j++)
+                {
+                    fprintf(fpt, "%d\t", pop->ind[i].perm[j]);
+                }
+            }
+
             fprintf(fpt, "%e\t", pop->ind[i].constr_violation);
             fprintf(fpt, "%d\t", pop->ind[i].rank);
             fprintf(fpt, "%e\n", pop->ind[i].crowd_dist);
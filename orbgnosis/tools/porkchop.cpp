@@ -0,0 +1,144 @@
+/*-
+* Copyright (c) 2007 Ted Stodgell. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+* $Id$
+*
+* Contributor(s):  Ted Stodgell <trs137@psu.edu>
+*/
+
+/** @file
+ * Porkchop plot generator.
+ *
+ * Reads a list of orbital elements (see Catalog), sweeps a grid of
+ * departure times and times of flight between two of them, and writes the
+ * delta-V landscape in the binary format of Porkchop.h, optionally also as
+ * text.  All times are canonical units measured from epoch.
+ *
+ *   porkchop elsets.txt 1 2  0 10 200  0.5 20 400  1-2.grid 1-2.csv
+ *
+ * Set OMP_NUM_THREADS to choose the number of threads.
+ */
+
+#include "Catalog.h"
+#include "Constellation.h"
+#include "Orbgnosis.h"
+#include "Porkchop.h"
+#include "Timer.h"
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+int
+main ( int argc, char** argv )
+{
+    if ( ( argc != 11 ) && ( argc != 12 ) )
+    {
+        cerr << "Usage: porkchop elsets from to t0 t1 nt tof0 tof1 ntof grid [csv]" << endl;
+        cerr << "  elsets       file of orbital elements, one target per line" << endl;
+        cerr << "  from, to     target numbers, counting from 0" << endl;
+        cerr << "  t0, t1, nt   departure times (TU) and how many" << endl;
+        cerr << "  tof0, tof1, ntof  times of flight (TU) and how many" << endl;
+        cerr << "  grid         binary output file" << endl;
+        cerr << "  csv          optional text output file" << endl;
+        exit( 1 );
+    }
+
+    Catalog cat( argv[ 1 ] );
+    vector<int> pair( 2 );
+    pair[ 0 ] = atoi( argv[ 2 ] );
+    pair[ 1 ] = atoi( argv[ 3 ] );
+
+    for ( int k = 0; k < 2; k++ )
+        if ( ( pair[ k ] < 0 ) || ( pair[ k ] >= cat.size() ) )
+        {
+            cerr << "ERROR: " << argv[ 1 ] << " has only " << cat.size()
+            << " targets." << endl;
+            exit( 1 );
+        }
+
+    // The file may be a whole catalog; only the two ends become Trajs.
+    Constellation con = cat.constellation( pair );
+    Porkchop pc( con.t10s[ 0 ], con.t10s[ 1 ] );
+    pc.set_grid( atof( argv[ 4 ] ), atof( argv[ 5 ] ), atoi( argv[ 6 ] ),
+                 atof( argv[ 7 ] ), atof( argv[ 8 ] ), atoi( argv[ 9 ] ) );
+
+    double start = wall_time();
+    pc.sweep();
+    double elapsed = wall_time() - start;
+
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+
+    // Find the cheapest cell.
+    int best_r = 0, best_c = 0, feasible = 0;
+    for ( int r = 0; r < pc.nt; r++ )
+    {
+        for ( int c = 0; c < pc.ntof; c++ )
+        {
+            if ( pc.get_cell( r, c ).dv < INF )
+                feasible++;
+
+            if ( pc.get_cell( r, c ).dv < pc.get_cell( best_r, best_c ).dv )
+            {
+                best_r = r;
+                best_c = c;
+            }
+        }
+    }
+
+    cout << pc.nt * pc.ntof << " cells in " << elapsed << " s on " << threads
+    << " threads (" << pc.nt * pc.ntof / elapsed << " cells/s), "
+    << feasible << " feasible." << endl;
+
+    if ( feasible > 0 )
+    {
+        Transfer best = pc.get_cell( best_r, best_c );
+        cout << "Best: depart " << pc.get_t( best_r ) << " TU, fly "
+        << pc.get_tof( best_c ) << " TU, " << best.dv * ERTU << " m/s, "
+        << best.revs << ( best.longway ? " revs long way." : " revs short way." )
+        << endl;
+    }
+
+    if ( ! pc.write( argv[ 10 ] ) )
+    {
+        cerr << "ERROR: could not write " << argv[ 10 ] << endl;
+        exit( 1 );
+    }
+
+    if ( ( argc == 12 ) && ! pc.write_csv( argv[ 11 ] ) )
+    {
+        cerr << "ERROR: could not write " << argv[ 11 ] << endl;
+        exit( 1 );
+    }
+
+    return 0;
+}